@@ -64,11 +64,15 @@ ASFLAGS += -DSAMA5D2
 endif
 
 ifeq ($(CORE_ARM926EJS), y)
+CPPFLAGS += -DCORE_ARM926EJS
+ASFLAGS += -DCORE_ARM926EJS
 CPPFLAGS += -mcpu=arm926ej-s -mtune=arm926ej-s -mfloat-abi=soft
 ASFLAGS += -mcpu=arm926ej-s -mtune=arm926ej-s -mfloat-abi=soft
 endif
 
 ifeq ($(CORE_CORTEX_A5), y)
+CPPFLAGS += -DCORE_CORTEX_A5
+ASFLAGS += -DCORE_CORTEX_A5
 gcc_cortexa5=$(shell $(CC) --target-help | grep cortex-a5)
 ifneq (, $(findstring cortex-a5,$(gcc_cortexa5)))
 CPPFLAGS += -mcpu=cortex-a5 -mtune=cortex-a5
@@ -31,6 +31,7 @@
 #include "usart.h"
 #include "debug.h"
 #include "ddramc.h"
+#include "ddramc_timings.h"
 #include "gpio.h"
 #include "timer.h"
 #include "watchdog.h"
@@ -253,6 +254,21 @@ static int matrix_init(void)
 }
 #endif	/* #if defined(CONFIG_MATRIX) */
 
+/*
+ * A timing clamped to its field is shorter than the part requires: the
+ * memory would not be reliable, so do not boot from it.
+ */
+static void ddramc_part_config(const struct ddram_part *part,
+			       struct ddramc_register *ddramc_config)
+{
+	if (ddramc_timings_config(part, ddramc_config)) {
+		dbg_info("DDR: stop the boot\n");
+		usart_flush();
+		while (1)
+			;
+	}
+}
+
 #if defined(CONFIG_DDR3)
 static void ddramc_reg_config(struct ddramc_register *ddramc_config)
 {
@@ -268,14 +284,6 @@ static void ddramc_reg_config(struct ddramc_register *ddramc_config)
 				| AT91C_DDRC2_DECOD_INTERLEAVED
 				| AT91C_DDRC2_UNAL_SUPPORTED);
 
-	/*
-	 * According to MT41K128M16 datasheet
-	 * Maximum fresh period: 64ms, refresh count: 8k
-	 */
-#ifdef CONFIG_BUS_SPEED_166MHZ
-	/* Refresh Timer is (64ms / 8k) * 166MHz = 1297(0x511) */
-	ddramc_config->rtr = 0x511;
-
 	/*
 	 * According to the sama5d2 datasheet and the following values:
 	 * T Sens = 0.75%/C, V Sens = 0.2%/mV, T driftrate = 1C/sec and V driftrate = 15 mV/s
@@ -286,32 +294,7 @@ static void ddramc_reg_config(struct ddramc_register *ddramc_config)
 	 * */
 	ddramc_config->cal_mr4r = AT91C_DDRC2_COUNT_CAL(0xC852);
 
-	/* DDR3 ZQCS */
-	ddramc_config->tim_calr = AT91C_DDRC2_ZQCS(64);
-
-	/* Assume timings for 8ns min clock period */
-	ddramc_config->t0pr = (AT91C_DDRC2_TRAS_(6)
-			| AT91C_DDRC2_TRCD_(3)
-			| AT91C_DDRC2_TWR_(4)
-			| AT91C_DDRC2_TRC_(9)
-			| AT91C_DDRC2_TRP_(3)
-			| AT91C_DDRC2_TRRD_(4)
-			| AT91C_DDRC2_TWTR_(4)
-			| AT91C_DDRC2_TMRD_(4));
-
-	ddramc_config->t1pr = (AT91C_DDRC2_TRFC_(27)
-			| AT91C_DDRC2_TXSNR_(29)
-			| AT91C_DDRC2_TXSRD_(0)
-			| AT91C_DDRC2_TXP_(3));
-
-	ddramc_config->t2pr = (AT91C_DDRC2_TXARD_(0)
-			| AT91C_DDRC2_TXARDS_(0)
-			| AT91C_DDRC2_TRPA_(0)
-			| AT91C_DDRC2_TRTP_(4)
-			| AT91C_DDRC2_TFAW_(7));
-#else
-#error "No CLK setting defined"
-#endif
+	ddramc_part_config(&ddram_mt41k128m16_125, ddramc_config);
 }
 
 static void ddramc_init(void)
@@ -355,37 +338,7 @@ static void lpddr1_reg_config(struct ddramc_register *ddramc_config)
 
 	ddramc_config->lpr = 0;
 
-	/*
-	 * According to MT46H128M16LF-5 IT datasheet
-	 * Maximum fresh period: 64ms, refresh count: 8k
-	 */
-#ifdef CONFIG_BUS_SPEED_166MHZ
-	/* Refresh Timer is (64ms / 8k) * 166MHz = 1297(0x511) */
-	ddramc_config->rtr = 0x511;
-
-	/* Assume the timings for 6ns min clock period */
-	ddramc_config->t0pr = (AT91C_DDRC2_TRAS_(7) |
-			       AT91C_DDRC2_TRCD_(3) |
-			       AT91C_DDRC2_TWR_(3) |
-			       AT91C_DDRC2_TRC_(10) |
-			       AT91C_DDRC2_TRP_(3) |
-			       AT91C_DDRC2_TRRD_(2) |
-			       AT91C_DDRC2_TWTR_(2) |
-			       AT91C_DDRC2_TMRD_(2));
-
-	ddramc_config->t1pr = (AT91C_DDRC2_TRFC_(12)  |
-			       AT91C_DDRC2_TXSNR_(19) |
-			       AT91C_DDRC2_TXSRD_(0) |
-			       AT91C_DDRC2_TXP_(2));
-
-	ddramc_config->t2pr = (AT91C_DDRC2_TXARD_(0) |
-			       AT91C_DDRC2_TXARDS_(0) |
-			       AT91C_DDRC2_TRPA_(0) |
-			       AT91C_DDRC2_TRTP_(0) |
-			       AT91C_DDRC2_TFAW_(0));
-#else
-#error "No CLK setting defined"
-#endif
+	ddramc_part_config(&ddram_mt46h128m16lf_5, ddramc_config);
 }
 
 static void lpddr1_init(void)
@@ -441,38 +394,7 @@ static void lpddr2_reg_config(struct ddramc_register *ddramc_config)
 
 	ddramc_config->lpddr2_lpr = AT91C_LPDDRC2_DS(0x03);
 
-#ifdef CONFIG_BUS_SPEED_166MHZ
-	/*
-	 * The MT42128M32 refresh window: 32ms
-	 * Required number of REFRESH commands(MIN): 8192
-	 * (32ms / 8192) * 166MHz = 0x288.
-	 */
-	ddramc_config->rtr = 0x288;
-	/* 90n short calibration: ZQCS */
-	ddramc_config->tim_calr = AT91C_DDRC2_ZQCS(12);
-
-	ddramc_config->t0pr = (AT91C_DDRC2_TRAS_(7) |
-			       AT91C_DDRC2_TRCD_(3) |
-			       AT91C_DDRC2_TWR_(3) |
-			       AT91C_DDRC2_TRC_(11) |
-			       AT91C_DDRC2_TRP_(4) |
-			       AT91C_DDRC2_TRRD_(2) |
-			       AT91C_DDRC2_TWTR_(2) |
-			       AT91C_DDRC2_TMRD_(3));
-
-	ddramc_config->t1pr = (AT91C_DDRC2_TRFC_(35) |
-				AT91C_DDRC2_TXSNR_(37) |
-				AT91C_DDRC2_TXSRD_(0) |
-				AT91C_DDRC2_TXP_(2));
-
-	ddramc_config->t2pr = (AT91C_DDRC2_TXARD_(0) |
-			       AT91C_DDRC2_TXARDS_(0) |
-			       AT91C_DDRC2_TRPA_(0) |
-			       AT91C_DDRC2_TRTP_(2) |
-			       AT91C_DDRC2_TFAW_(9));
-#else
-#error "No CLK setting defined"
-#endif
+	ddramc_part_config(&ddram_mt42l128m32d1_25, ddramc_config);
 }
 
 static void lpddr2_init(void)
@@ -515,32 +437,7 @@ static void lpddr3_reg_config(struct ddramc_register *ddramc_config)
 
 	ddramc_config->lpddr2_lpr = AT91C_LPDDRC2_DS(0x04);
 
-#ifdef CONFIG_BUS_SPEED_166MHZ
-	/* The low-power DDR3-SDRAM device requires a refresh every 3.9 us.*/
-	ddramc_config->rtr = 0x288;
-
-	ddramc_config->t0pr = (AT91C_DDRC2_TRAS_(7) |
-			       AT91C_DDRC2_TRCD_(3) |
-			       AT91C_DDRC2_TWR_(3) |
-			       AT91C_DDRC2_TRC_(11) |
-			       AT91C_DDRC2_TRP_(4) |
-			       AT91C_DDRC2_TRRD_(2) |
-			       AT91C_DDRC2_TWTR_(4) |
-			       AT91C_DDRC2_TMRD_(10));
-
-	ddramc_config->t1pr = (AT91C_DDRC2_TRFC_(35) |
-			       AT91C_DDRC2_TXSNR_(37) |
-			       AT91C_DDRC2_TXSRD_(0) |
-			       AT91C_DDRC2_TXP_(2));
-
-	ddramc_config->t2pr = (AT91C_DDRC2_TXARD_(0) |
-			       AT91C_DDRC2_TXARDS_(0) |
-			       AT91C_DDRC2_TRPA_(0) |
-			       AT91C_DDRC2_TRTP_(4) |
-			       AT91C_DDRC2_TFAW_(9));
-#else
-#error "No CLK setting defined"
-#endif
+	ddramc_part_config(&ddram_lpddr3_8gb_1600, ddramc_config);
 }
 
 static void lpddr3_init(void)
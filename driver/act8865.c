@@ -30,6 +30,7 @@
 #include "board.h"
 #include "twi.h"
 #include "act8865.h"
+#include "usart.h"
 #include "debug.h"
 
 /*
@@ -289,6 +290,7 @@ void act8865_workaround(void)
 	/* Disable ACT8865 I2C interface, if failed, don't go on */
 	if (act8865_workaround_disable_i2c()) {
 		dbg_loud("ACT8865: Failed to disable I2C interface\n");
+		usart_flush();
 		while (1)
 			;
 	}
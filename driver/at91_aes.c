@@ -32,6 +32,14 @@
 #include "debug.h"
 #include "board.h"
 #include "string.h"
+#include "timer.h"
+
+/*
+ * A block takes a few dozen cycles: only look at the time when the
+ * engine is slow to answer.
+ */
+#define AES_POLLS_BEFORE_TIMER	64
+#define AES_TIMEOUT_US		1000
 
 #define swab32(x) (			\
 	(((x) & 0x000000ffUL) << 24) |	\
@@ -70,6 +78,26 @@ static inline void aes_writeb(unsigned int reg, unsigned char value)
 }
 
 
+static int at91_aes_wait(unsigned int flag)
+{
+	unsigned long long deadline = 0;
+	unsigned int polls = 0;
+
+	while (!(aes_readl(AES_ISR) & flag)) {
+		if (++polls < AES_POLLS_BEFORE_TIMER)
+			continue;
+
+		if (!deadline)
+			deadline = timer_deadline_usec(AES_TIMEOUT_US);
+		else if (timer_expired(deadline)) {
+			dbg_info("AES: timeout, ISR: %x\n", aes_readl(AES_ISR));
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
 void at91_aes_init(void)
 {
 	/* Enable peripheral clock */
@@ -240,7 +268,7 @@ static inline int at91_aes_set_key(at91_aes_key_size_t key_size,
 }
 
 
-static void at91_aes_compute_pio_long(unsigned int chunk_size,
+static int at91_aes_compute_pio_long(unsigned int chunk_size,
 				      unsigned int num_blocks,
 				      unsigned int is_mac,
 				      const unsigned int *input,
@@ -253,7 +281,8 @@ static void at91_aes_compute_pio_long(unsigned int chunk_size,
 		for (i = 0; i < chunk_size; ++i, reg += 4)
 			aes_writel(reg, *input++);
 
-		while (!(aes_readl(AES_ISR) & AES_INT_DATRDY));
+		if (at91_aes_wait(AES_INT_DATRDY))
+			return -1;
 		if (is_mac)
 			continue;
 
@@ -261,9 +290,11 @@ static void at91_aes_compute_pio_long(unsigned int chunk_size,
 		for (i = 0; i < chunk_size; ++i, reg += 4)
 			*output++ = aes_readl(reg);
 	}
+
+	return 0;
 }
 
-static void at91_aes_compute_pio_word(unsigned int num_blocks,
+static int at91_aes_compute_pio_word(unsigned int num_blocks,
 				      unsigned int is_mac,
 				      const unsigned short *input,
 				      unsigned short *output)
@@ -273,15 +304,18 @@ static void at91_aes_compute_pio_word(unsigned int num_blocks,
 	for (n = 0; n < num_blocks; ++n) {
 		aes_writew(AES_IDATAR0, *input++);
 
-		while (!(aes_readl(AES_ISR) & AES_INT_DATRDY));
+		if (at91_aes_wait(AES_INT_DATRDY))
+			return -1;
 		if (is_mac)
 			continue;
 
 		*output++ = aes_readw(AES_ODATAR0);
 	}
+
+	return 0;
 }
 
-static void at91_aes_compute_pio_byte(unsigned int num_blocks,
+static int at91_aes_compute_pio_byte(unsigned int num_blocks,
 				      unsigned int is_mac,
 				      const unsigned char *input,
 				      unsigned char *output)
@@ -291,46 +325,46 @@ static void at91_aes_compute_pio_byte(unsigned int num_blocks,
 	for (n = 0; n < num_blocks; ++n) {
 		aes_writeb(AES_IDATAR0, *input++);
 
-		while (!(aes_readl(AES_ISR) & AES_INT_DATRDY));
+		if (at91_aes_wait(AES_INT_DATRDY))
+			return -1;
 		if (is_mac)
 			continue;
 
 		*output++ = aes_readb(AES_ODATAR0);
 	}
+
+	return 0;
 }
 
-static void at91_aes_compute_pio(unsigned int data_width,
-				 unsigned int chunk_size,
-				 unsigned int num_blocks,
-				 unsigned int is_mac,
-				 const void *input,
-				 void *output)
+static int at91_aes_compute_pio(unsigned int data_width,
+				unsigned int chunk_size,
+				unsigned int num_blocks,
+				unsigned int is_mac,
+				const void *input,
+				void *output)
 {
 	switch (data_width) {
 	case 4:
-		at91_aes_compute_pio_long(chunk_size,
-					  num_blocks,
-					  is_mac,
-					  (const unsigned int *)input,
-					  (unsigned int *)output);
-		break;
+		return at91_aes_compute_pio_long(chunk_size,
+						 num_blocks,
+						 is_mac,
+						 (const unsigned int *)input,
+						 (unsigned int *)output);
 
 	case 2:
-		at91_aes_compute_pio_word(num_blocks,
-					  is_mac,
-					  (const unsigned short *)input,
-					  (unsigned short *)output);
-		break;
+		return at91_aes_compute_pio_word(num_blocks,
+						 is_mac,
+						 (const unsigned short *)input,
+						 (unsigned short *)output);
 
 	case 1:
-		at91_aes_compute_pio_byte(num_blocks,
-					  is_mac,
-					  (const unsigned char *)input,
-					  (unsigned char *)output);
-		break;
+		return at91_aes_compute_pio_byte(num_blocks,
+						 is_mac,
+						 (const unsigned char *)input,
+						 (unsigned char *)output);
 
 	default:
-		break;
+		return -1;
 	}
 }
 
@@ -393,8 +427,9 @@ static int at91_aes_process(const at91_aes_params_t *params)
 
 	block_size = data_width * chunk_size;
 	num_blocks = at91_aes_length2blocks(params->data_length, block_size);
-	at91_aes_compute_pio(data_width, chunk_size, num_blocks,
-			     is_mac, params->input, params->output);
+	if (at91_aes_compute_pio(data_width, chunk_size, num_blocks,
+				 is_mac, params->input, params->output))
+		return -1;
 
 	if (is_mac) {
 		unsigned int reg, i;
@@ -433,36 +468,23 @@ int at91_aes_cbc(unsigned int data_length,
 	return at91_aes_process(&params);
 }
 
-int at91_aes_cmac(unsigned int data_length,
-		  const void *data,
-		  unsigned int *cmac,
-		  at91_aes_key_size_t key_size,
-		  const unsigned int *key)
+static int at91_aes_cmac_subkey(at91_aes_key_size_t key_size,
+				const unsigned int *key,
+				unsigned int *subkey)
 {
 	static const unsigned int null_block[AT91_AES_BLOCK_SIZE_WORD];
-	static const unsigned int null_iv[AT91_AES_IV_SIZE_WORD];
-	unsigned int last_input[AT91_AES_BLOCK_SIZE_WORD];
-	unsigned int subkey[AT91_AES_BLOCK_SIZE_WORD];
-	const unsigned int *input = (const unsigned int *)data;
-	unsigned int num_blocks, offset;
 	at91_aes_params_t params;
 	unsigned char carry;
 	int i; /* MUST be signed for the subkey loop */
 
-	if (!data_length || !data || !cmac || !key)
-		return -1;
-
-	/* Set common parameters once for all */
 	memset(&params, 0, sizeof(params));
-	params.key_size = key_size;
-	params.key = key;
-
-	/* Generate the subkey */
 	params.operation = AT91_AES_OP_ENCRYPT;
 	params.mode = AT91_AES_MODE_ECB;
 	params.data_length = AT91_AES_BLOCK_SIZE_BYTE;
 	params.input = null_block;
 	params.output = subkey;
+	params.key_size = key_size;
+	params.key = key;
 	if (at91_aes_process(&params))
 		return -1;
 
@@ -478,31 +500,194 @@ int at91_aes_cmac(unsigned int data_length,
 	carry = (0 - carry) & 0x87;
 	((unsigned char *)subkey)[AT91_AES_BLOCK_SIZE_BYTE-1] ^= carry;
 
-	/* Process the n-1 first blocks */
-	num_blocks = at91_aes_length2blocks(data_length,
-					    AT91_AES_BLOCK_SIZE_BYTE);
-	if (num_blocks > 1) {
-		params.operation = AT91_AES_OP_MAC;
-		params.mode = AT91_AES_MODE_CBC;
-		params.iv = null_iv;
-		params.data_length = data_length - AT91_AES_BLOCK_SIZE_BYTE;
-		params.input = data;
-		params.output = cmac;
-		if (at91_aes_process(&params))
-			return -1;
-	} else {
-		memset(cmac, 0, AT91_AES_BLOCK_SIZE_BYTE);
-	}
+	return 0;
+}
+
+/*
+ * Chain whole blocks, all but the last one of the message, into the
+ * running CMAC value: this may be called once per chunk of data.
+ */
+int at91_aes_cmac_update(unsigned int data_length,
+			 const void *data,
+			 unsigned int *cmac,
+			 at91_aes_key_size_t key_size,
+			 const unsigned int *key)
+{
+	at91_aes_params_t params;
+
+	if (!data_length || !data || !cmac || !key)
+		return -1;
+
+	memset(&params, 0, sizeof(params));
+	params.operation = AT91_AES_OP_MAC;
+	params.mode = AT91_AES_MODE_CBC;
+	params.data_length = data_length;
+	params.input = data;
+	params.output = cmac;
+	params.key_size = key_size;
+	params.key = key;
+	params.iv = cmac;
+
+	return at91_aes_process(&params);
+}
+
+/* Process the last block of the message into the final CMAC value */
+int at91_aes_cmac_final(const void *last_block,
+			unsigned int *cmac,
+			at91_aes_key_size_t key_size,
+			const unsigned int *key)
+{
+	unsigned int last_input[AT91_AES_BLOCK_SIZE_WORD];
+	unsigned int subkey[AT91_AES_BLOCK_SIZE_WORD];
+	const unsigned int *input = (const unsigned int *)last_block;
+	at91_aes_params_t params;
+	int i;
+
+	if (!last_block || !cmac || !key)
+		return -1;
+
+	if (at91_aes_cmac_subkey(key_size, key, subkey))
+		return -1;
 
-	/* Process the last block */
-	offset = (num_blocks-1) * AT91_AES_BLOCK_SIZE_WORD;
 	for (i = 0; i < AT91_AES_BLOCK_SIZE_WORD; ++i)
-		last_input[i] = input[offset + i] ^ cmac[i] ^ subkey[i];
+		last_input[i] = input[i] ^ cmac[i] ^ subkey[i];
 
+	memset(&params, 0, sizeof(params));
 	params.operation = AT91_AES_OP_ENCRYPT;
 	params.mode = AT91_AES_MODE_ECB;
 	params.data_length = AT91_AES_BLOCK_SIZE_BYTE;
 	params.input = last_input;
 	params.output = cmac;
+	params.key_size = key_size;
+	params.key = key;
 	return at91_aes_process(&params);
 }
+
+int at91_aes_cmac(unsigned int data_length,
+		  const void *data,
+		  unsigned int *cmac,
+		  at91_aes_key_size_t key_size,
+		  const unsigned int *key)
+{
+	const unsigned int *input = (const unsigned int *)data;
+	unsigned int num_blocks;
+
+	if (!data_length || !data || !cmac || !key)
+		return -1;
+
+	/* Process the n-1 first blocks */
+	memset(cmac, 0, AT91_AES_BLOCK_SIZE_BYTE);
+	num_blocks = at91_aes_length2blocks(data_length,
+					    AT91_AES_BLOCK_SIZE_BYTE);
+	if (num_blocks > 1) {
+		if (at91_aes_cmac_update((num_blocks - 1)
+					 * AT91_AES_BLOCK_SIZE_BYTE,
+					 data, cmac, key_size, key))
+			return -1;
+	}
+
+	/* Process the last block */
+	return at91_aes_cmac_final(input
+				   + (num_blocks - 1) * AT91_AES_BLOCK_SIZE_WORD,
+				   cmac, key_size, key);
+}
+
+#ifdef CPU_HAS_AES_GCM
+/*
+ * GCM decryption, authenticated and decrypted in a single pass: the
+ * engine computes the hash subkey from the key, GHASHes the AAD and the
+ * cipher text as they go through, and generates the tag at the end.
+ * at91_aes_gcm_update() may be called once per chunk of the message,
+ * with whole blocks, until the @data_length given to the start is met.
+ */
+int at91_aes_gcm_start(at91_aes_key_size_t key_size,
+		       const unsigned int *key,
+		       const unsigned int *iv,
+		       const void *aad,
+		       unsigned int aad_length,
+		       unsigned int data_length)
+{
+	unsigned int data_width, chunk_size;
+	unsigned int i, reg = AES_IVR0;
+
+	if (!key || !iv || !data_length)
+		return -1;
+
+	/* Reset AES */
+	aes_writel(AES_CR, AES_CR_SWRST);
+
+	if (at91_aes_set_opmode(AT91_AES_OP_DECRYPT, AT91_AES_MODE_GCM,
+				key_size, &data_width, &chunk_size))
+		return -1;
+
+	aes_writel(AES_MR, aes_readl(AES_MR) | AES_MR_GTAGEN);
+
+	if (at91_aes_set_key(key_size, key))
+		return -1;
+
+	/* The hash subkey H is ready */
+	if (at91_aes_wait(AES_INT_DATRDY))
+		return -1;
+
+	/* inc32(J0), with J0 = IV || 0^31 || 1 for a 96-bit IV */
+	for (i = 0; i < AT91_AES_GCM_IV_SIZE_WORD; ++i, reg += 4)
+		aes_writel(reg, swab32(iv[i]));
+	aes_writel(AES_IVR3, swab32(2));
+
+	aes_writel(AES_AADLENR, aad_length);
+	aes_writel(AES_CLENR, data_length);
+
+	if (aad_length)
+		return at91_aes_compute_pio_long(chunk_size,
+			at91_aes_length2blocks(aad_length,
+					       AT91_AES_BLOCK_SIZE_BYTE),
+			1, (const unsigned int *)aad, 0);
+
+	return 0;
+}
+
+int at91_aes_gcm_update(unsigned int data_length,
+			const void *input,
+			void *output)
+{
+	return at91_aes_compute_pio_long(AT91_AES_BLOCK_SIZE_WORD,
+		at91_aes_length2blocks(data_length, AT91_AES_BLOCK_SIZE_BYTE),
+		0, (const unsigned int *)input, (unsigned int *)output);
+}
+
+int at91_aes_gcm_final(unsigned int *tag)
+{
+	unsigned int i, reg = AES_TAGR0;
+
+	if (at91_aes_wait(AES_INT_TAGRDY))
+		return -1;
+
+	for (i = 0; i < AT91_AES_BLOCK_SIZE_WORD; ++i, reg += 4)
+		tag[i] = aes_readl(reg);
+
+	return 0;
+}
+
+int at91_aes_gcm(unsigned int data_length,
+		 const void *input,
+		 void *output,
+		 at91_aes_key_size_t key_size,
+		 const unsigned int *key,
+		 const unsigned int *iv,
+		 const void *aad,
+		 unsigned int aad_length,
+		 unsigned int *tag)
+{
+	if (!input || !output || !tag)
+		return -1;
+
+	if (at91_aes_gcm_start(key_size, key, iv, aad, aad_length,
+			       data_length))
+		return -1;
+
+	if (at91_aes_gcm_update(data_length, input, output))
+		return -1;
+
+	return at91_aes_gcm_final(tag);
+}
+#endif /* #ifdef CPU_HAS_AES_GCM */
@@ -0,0 +1,253 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2017, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hardware.h"
+#include "board.h"
+#include "pmc.h"
+#include "arch/at91_dmac.h"
+#include "dma.h"
+#include "mmu.h"
+#include "timer.h"
+#include "debug.h"
+
+#if defined(AT91C_BASE_DMAC0)
+#define DMAC_BASE	AT91C_BASE_DMAC0
+#define DMAC_ID		AT91C_ID_DMAC0
+#else
+#define DMAC_BASE	AT91C_BASE_DMAC
+#define DMAC_ID		AT91C_ID_DMAC
+#endif
+
+/* AHB interfaces: memories on IF0, peripherals on IF1 (IF2 on SAMA5D3) */
+#define DMAC_MEM_IF	0
+#if defined(SAMA5D3X)
+#define DMAC_PER_IF	2
+#else
+#define DMAC_PER_IF	1
+#endif
+
+/* A disabled channel first completes its current AHB burst */
+#define DMAC_STOP_TIMEOUT_US	1000
+
+/* Linked list item, loaded into SADDR..CTRLB and DSCR */
+struct dmac_lli {
+	unsigned int	saddr;
+	unsigned int	daddr;
+	unsigned int	ctrla;
+	unsigned int	ctrlb;
+	unsigned int	dscr;
+};
+
+static struct dmac_lli dmac_lli[DMA_CHANNELS][DMA_LIST_MAX]
+					__attribute__((aligned(32)));
+
+/* EBCISR is cleared on read: keep the bits of the other channels */
+static unsigned int dmac_ebcisr;
+
+static inline unsigned int dmac_readl(unsigned int reg)
+{
+	return readl(DMAC_BASE + reg);
+}
+
+static inline void dmac_writel(unsigned int reg, unsigned int value)
+{
+	writel(value, DMAC_BASE + reg);
+}
+
+static inline void dmac_ch_writel(unsigned int chan,
+				  unsigned int reg,
+				  unsigned int value)
+{
+	writel(value, DMAC_BASE + DMAC_CH(chan) + reg);
+}
+
+static unsigned int dmac_status(void)
+{
+	dmac_ebcisr |= dmac_readl(DMAC_EBCISR);
+
+	return dmac_ebcisr;
+}
+
+void dma_init(void)
+{
+	unsigned int chan;
+
+	pmc_enable_periph_clock(DMAC_ID);
+
+	dmac_writel(DMAC_EN, DMAC_EN_ENABLE);
+	dmac_writel(DMAC_EBCIDR, 0xffffffff);
+
+	for (chan = 0; chan < DMA_CHANNELS; chan++)
+		dma_stop(chan);
+}
+
+void dma_cleanup(void)
+{
+	unsigned int chan;
+
+	for (chan = 0; chan < DMA_CHANNELS; chan++)
+		dma_stop(chan);
+
+	dmac_writel(DMAC_EN, 0);
+	pmc_disable_periph_clock(DMAC_ID);
+}
+
+int dma_hw_start(unsigned int chan,
+		 unsigned int perid,
+		 unsigned int width,
+		 const struct dma_xfer *list,
+		 unsigned int count)
+{
+	struct dmac_lli *lli = dmac_lli[chan];
+	unsigned int max = DMAC_CTRLA_BTSIZE_MAX << width;
+	unsigned int id = perid & DMA_PERID_MASK;
+	unsigned int src_incr, dst_incr;
+	unsigned int src, dst, len, size;
+	unsigned int ctrla, ctrlb, cfg;
+	unsigned int i, n = 0;
+
+	if (perid == DMA_PERID_NONE) {
+		ctrla = DMAC_CTRLA_SCSIZE_CHK_16 | DMAC_CTRLA_DCSIZE_CHK_16;
+		ctrlb = DMAC_CTRLB_SIF(DMAC_MEM_IF)
+			| DMAC_CTRLB_DIF(DMAC_MEM_IF)
+			| DMAC_CTRLB_FC_MEM2MEM
+			| DMAC_CTRLB_SRC_INCR_INCREMENTING
+			| DMAC_CTRLB_DST_INCR_INCREMENTING;
+		cfg = DMAC_CFG_FIFOCFG_HALF;
+		src_incr = 1;
+		dst_incr = 1;
+	} else if (perid & DMA_PERID_MEM2PER) {
+		src_incr = !(perid & DMA_PERID_SRC_FIXED);
+		dst_incr = 0;
+		ctrla = DMAC_CTRLA_SCSIZE_CHK_1 | DMAC_CTRLA_DCSIZE_CHK_1;
+		ctrlb = DMAC_CTRLB_SIF(DMAC_MEM_IF)
+			| DMAC_CTRLB_DIF(DMAC_PER_IF)
+			| DMAC_CTRLB_FC_MEM2PER
+			| (src_incr ? DMAC_CTRLB_SRC_INCR_INCREMENTING
+				    : DMAC_CTRLB_SRC_INCR_FIXED)
+			| DMAC_CTRLB_DST_INCR_FIXED;
+		cfg = DMAC_CFG_DST_PER(id)
+			| DMAC_CFG_DST_PER_MSB(id)
+			| DMAC_CFG_DST_H2SEL_HW
+			| DMAC_CFG_FIFOCFG_HALF;
+	} else {
+		ctrla = DMAC_CTRLA_SCSIZE_CHK_1 | DMAC_CTRLA_DCSIZE_CHK_1;
+		ctrlb = DMAC_CTRLB_SIF(DMAC_PER_IF)
+			| DMAC_CTRLB_DIF(DMAC_MEM_IF)
+			| DMAC_CTRLB_FC_PER2MEM
+			| DMAC_CTRLB_SRC_INCR_FIXED
+			| DMAC_CTRLB_DST_INCR_INCREMENTING;
+		cfg = DMAC_CFG_SRC_PER(id)
+			| DMAC_CFG_SRC_PER_MSB(id)
+			| DMAC_CFG_SRC_H2SEL_HW
+			| DMAC_CFG_FIFOCFG_HALF;
+		src_incr = 0;
+		dst_incr = 1;
+	}
+	ctrla |= DMAC_CTRLA_SRC_WIDTH(width) | DMAC_CTRLA_DST_WIDTH(width);
+
+	for (i = 0; i < count; i++) {
+		src = list[i].src;
+		dst = list[i].dst;
+		len = list[i].len;
+
+		while (len) {
+			if (n == DMA_LIST_MAX)
+				return -1;
+
+			size = (len > max) ? max : len;
+
+			lli[n].saddr = src;
+			lli[n].daddr = dst;
+			lli[n].ctrla = ctrla | (size >> width);
+			lli[n].ctrlb = ctrlb;
+			lli[n].dscr = (unsigned int)&lli[n + 1]
+					| DMAC_DSCR_IF(DMAC_MEM_IF);
+			n++;
+
+			if (src_incr)
+				src += size;
+			if (dst_incr)
+				dst += size;
+			len -= size;
+		}
+	}
+
+	if (!n)
+		return -1;
+
+	/* End of the list: no descriptor is fetched after this one */
+	lli[n - 1].ctrlb |= DMAC_CTRLB_SRC_DSCR_FETCH_DISABLE
+			  | DMAC_CTRLB_DST_DSCR_FETCH_DISABLE;
+	lli[n - 1].dscr = 0;
+
+	dcache_clean_range((unsigned int)lli, (unsigned int)&lli[n]);
+
+	/* Clear the status left by a previous transfer */
+	dmac_status();
+	dmac_ebcisr &= ~(DMAC_EBCISR_BTC(chan)
+			| DMAC_EBCISR_CBTC(chan)
+			| DMAC_EBCISR_ERR(chan));
+
+	dmac_ch_writel(chan, DMAC_SADDR, 0);
+	dmac_ch_writel(chan, DMAC_DADDR, 0);
+	dmac_ch_writel(chan, DMAC_CTRLA, 0);
+	dmac_ch_writel(chan, DMAC_CTRLB, 0);
+	dmac_ch_writel(chan, DMAC_CFG, cfg);
+	dmac_ch_writel(chan, DMAC_DSCR,
+		       (unsigned int)lli | DMAC_DSCR_IF(DMAC_MEM_IF));
+
+	dmac_writel(DMAC_CHER, 1 << chan);
+
+	return 0;
+}
+
+int dma_poll(unsigned int chan)
+{
+	if (dmac_status() & DMAC_EBCISR_ERR(chan))
+		return -1;
+
+	if (dmac_readl(DMAC_CHSR) & DMAC_CHSR_ENA(chan))
+		return 0;
+
+	return 1;
+}
+
+void dma_stop(unsigned int chan)
+{
+	unsigned long long deadline;
+
+	dmac_writel(DMAC_CHDR, 1 << chan);
+
+	deadline = timer_deadline_usec(DMAC_STOP_TIMEOUT_US);
+	while (dmac_readl(DMAC_CHSR) & DMAC_CHSR_ENA(chan)) {
+		if (timer_expired(deadline)) {
+			dbg_info("DMA: channel %d: cannot be stopped\n", chan);
+			break;
+		}
+	}
+}
@@ -33,10 +33,15 @@
 #include "div.h"
 #include "debug.h"
 #include "pmc.h"
+#include "usart.h"
+#include "timer.h"
 
 #define DEFAULT_SD_BLOCK_LEN		512
 #define CONFIG_SYS_DEFAULT_CLK		400000
 
+/* The end of the transfer, once the data have been moved */
+#define MCI_TIMEOUT_DTIP_US		10000
+
 static inline unsigned int mci_readl(unsigned int reg)
 {
 	return readl((void *)CONFIG_SYS_BASE_MCI + reg);
@@ -206,7 +211,7 @@ static int at91_mci_read_block_data(unsigned int *data,
 	unsigned int words_to_read = bytes_to_read >> 2;
 	unsigned int words_of_block = block_len >> 2;
 	unsigned int tmp;
-	int timeout = 10000;
+	unsigned long long deadline;
 	int ret;
 
 	for (block = 0; block < blocks; block++) {
@@ -224,12 +229,13 @@ static int at91_mci_read_block_data(unsigned int *data,
 		}
 	}
 
-	while ((mci_readl(MCI_SR) & AT91C_MCI_DTIP) && (--timeout))
-		;
-
-	if (!timeout) {
-		dbg_loud("Data Transfer in Progress.\n");
-		return -1;
+	deadline = timer_deadline_usec(MCI_TIMEOUT_DTIP_US);
+	while (mci_readl(MCI_SR) & AT91C_MCI_DTIP) {
+		usart_poll();
+		if (timer_expired(deadline)) {
+			dbg_loud("Data Transfer in Progress.\n");
+			return -1;
+		}
 	}
 
 	return 0;
@@ -262,7 +268,7 @@ static int at91_mci_write_block_data(unsigned int *data,
 	unsigned int words_to_write = bytes_to_write >> 2;
 	unsigned int words_of_block = block_len >> 2;
 	unsigned int tmp = 0;
-	int timeout = 10000;
+	unsigned long long deadline;
 	int ret;
 
 	/* write the valid data of the block */
@@ -281,12 +287,13 @@ static int at91_mci_write_block_data(unsigned int *data,
 		}
 	}
 
-	while ((mci_readl(MCI_SR) & AT91C_MCI_DTIP) && (--timeout))
-		;
-
-	if (!timeout) {
-		dbg_loud("Data Transfer in Progress.\n");
-		return -1;
+	deadline = timer_deadline_usec(MCI_TIMEOUT_DTIP_US);
+	while (mci_readl(MCI_SR) & AT91C_MCI_DTIP) {
+		usart_poll();
+		if (timer_expired(deadline)) {
+			dbg_loud("Data Transfer in Progress.\n");
+			return -1;
+		}
 	}
 
 	return 0;
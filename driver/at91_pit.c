@@ -29,6 +29,8 @@
 #include "board.h"
 #include "debug.h"
 #include "pmc.h"
+#include "div.h"
+#include "usart.h"
 
 #include "arch/at91_pit.h"
 #include "arch/at91_pmc.h"
@@ -46,9 +48,23 @@ static inline void pit_writel(unsigned int value, unsigned reg)
 }
 
 /*
- * If MASTER_CLOCK = 132M, the maximum delay is about 520.6 second(8.6767 min).
- * it is long enough for using in bootstrap.
+ * The PIIR counts MCK / 16 periods since timer_init(): its 12-bit
+ * PICNT carries the overflows of its 20-bit CPIV, as PIV is 0xfffff.
+ * These 32 bits wrap after about 520 s at 132 MHz, they are extended
+ * to 64 bits by counting the wraps, which only requires a read of the
+ * counter more often than that.
  */
+#define PIT_TICKS_PER_MSEC	((MASTER_CLOCK / 1000) / 16)
+/* ticks per us, in 16.16 fixed point */
+#define PIT_TICKS_PER_USEC_Q16	\
+	((unsigned int)((((unsigned long long)MASTER_CLOCK / 16) << 16) \
+			/ 1000000))
+
+static unsigned int ticks_per_msec;
+static unsigned int ticks_per_usec_q16;
+static unsigned int ticks_last;
+static unsigned int ticks_wraps;
+
 int timer_init(void)
 {
 	pit_writel((MAX_PIV | AT91C_PIT_PITEN), PIT_MR);
@@ -59,6 +75,16 @@ int timer_init(void)
 #else
 	pmc_enable_periph_clock(AT91C_ID_SYS);
 #endif
+
+	/* The PIT runs from MCK / 2 when H32MXDIV is set */
+	if (pmc_check_mck_h32mxdiv()) {
+		ticks_per_msec = PIT_TICKS_PER_MSEC / 2;
+		ticks_per_usec_q16 = PIT_TICKS_PER_USEC_Q16 / 2;
+	} else {
+		ticks_per_msec = PIT_TICKS_PER_MSEC;
+		ticks_per_usec_q16 = PIT_TICKS_PER_USEC_Q16;
+	}
+
 	return 0;
 }
 
@@ -67,86 +93,104 @@ static unsigned int at91_get_pit_value(void)
 	return(pit_readl(PIT_PIIR));
 }
 
-/* Because the below statement is used in the function:
- *	((MASTER_CLOCK >> 10) * usec) is used,
- * to our 32-bit system. the argu "usec" maximum value is:
- * supposed "MASTER_CLOCK" is 132M.
- *	132000000 / 1024 = 128906
- *	(0xffffffff) / 128906 = 33318.
- * So the maximum delay time is 33318 us.
- */
-void udelay(unsigned int usec)
+unsigned long long timer_get_ticks64(void)
 {
-	unsigned int base = at91_get_pit_value();
-	unsigned int delay;
-	unsigned int current;
+	unsigned int ticks = at91_get_pit_value();
 
-	/* Since our division function which costs much run time
-	 * causes the delay time error.
-	 * So here using shifting to implement the division.
-	 * to change "1000" to "1024", this cause some inaccuacy,
-	 * but it is acceptable.
-	 * ((MASTER_CLOCK / 1024) * usec) / (16 * 1024)
-	 */
-	if (pmc_check_mck_h32mxdiv())
-		delay = (((MASTER_CLOCK / 2) >> 10) * usec) >> 14;
-	else
-		delay = ((MASTER_CLOCK >> 10) * usec) >> 14;
+	if (ticks < ticks_last)
+		ticks_wraps++;
+	ticks_last = ticks;
 
-	do {
-		current = at91_get_pit_value();
-		current -= base;
-	} while (current < delay);
+	return ((unsigned long long)ticks_wraps << 32) | ticks;
 }
 
-void mdelay(unsigned int msec)
+/* Rounded up, so that a wait lasts at least as long as asked */
+unsigned long long timer_usec_to_ticks(unsigned int usec)
+{
+	return (((unsigned long long)usec * ticks_per_usec_q16) + 0xffff) >> 16;
+}
+
+/* ns to us in 16.16 fixed point, by 65536 / 1000 rounded up */
+#define NSEC_TO_USEC_Q16(nsec)	(((unsigned long long)(nsec) * 8389) >> 7)
+
+unsigned long long timer_nsec_to_ticks(unsigned int nsec)
+{
+	return ((NSEC_TO_USEC_Q16(nsec) * ticks_per_usec_q16) + 0xffffffffULL)
+		>> 32;
+}
+
+unsigned long long timer_msec_to_ticks(unsigned int msec)
+{
+	return (unsigned long long)msec * ticks_per_msec;
+}
+
+unsigned long long timer_deadline_usec(unsigned int usec)
+{
+	return timer_get_ticks64() + timer_usec_to_ticks(usec);
+}
+
+unsigned long long timer_deadline_msec(unsigned int msec)
+{
+	return timer_get_ticks64() + timer_msec_to_ticks(msec);
+}
+
+int timer_expired(unsigned long long deadline)
 {
-	unsigned int base = at91_get_pit_value();
-	unsigned int delay;
-	unsigned int current;
+	return timer_get_ticks64() >= deadline;
+}
+
+static void timer_wait(unsigned long long deadline)
+{
+	while (!timer_expired(deadline))
+		usart_poll();
+}
 
-	if (pmc_check_mck_h32mxdiv())
-		delay = (((MASTER_CLOCK / 2) / 1000) * msec) / 16;
-	else
-		delay = ((MASTER_CLOCK / 1000) * msec) / 16;
+/*
+ * A tick lasts about 100 ns: wait one more, as the current one may be
+ * about to end.
+ */
+void ndelay(unsigned int nsec)
+{
+	timer_wait(timer_get_ticks64() + timer_nsec_to_ticks(nsec) + 1);
+}
 
-	do {
-		current = at91_get_pit_value();
-		current -= base;
-	} while (current < delay);
+void udelay(unsigned int usec)
+{
+	timer_wait(timer_deadline_usec(usec));
+}
+
+void mdelay(unsigned int msec)
+{
+	timer_wait(timer_deadline_msec(msec));
 }
 
 /* Init a special timer for slow clock switch function */
-static int timer1_base;
+static unsigned long long timer1_base;
 
 int start_interval_timer(void)
 {
-	timer1_base = at91_get_pit_value();
+	timer1_base = timer_get_ticks64();
 
 	return 0;
 }
 
-/* Because the below statement is used in the function:
- *	((MASTER_CLOCK / 1000) * msec) is used,
- * to our 32-bit system. the argu "msec" maximum value is:
- * supposed "MASTER_CLOCK" is 132M.
- *	(0xffffffff) / 132000 = 32537.
- * So the maximum delay time is 32537 ms.
- */
 int wait_interval_timer(unsigned int msec)
 {
-	unsigned int delay;
-	unsigned int current;
+	timer_wait(timer1_base + timer_msec_to_ticks(msec));
 
-	if (pmc_check_mck_h32mxdiv())
-		delay = (((MASTER_CLOCK / 2) / 1000) * msec) / 16;
-	else
-		delay = ((MASTER_CLOCK / 1000) * msec) / 16;
+	return 0;
+}
 
-	do {
-		current = at91_get_pit_value();
-		current -= timer1_base;
-	} while (current < delay);
+unsigned int timer_get_ticks(void)
+{
+	return (unsigned int)timer_get_ticks64();
+}
 
-	return 0;
+unsigned int timer_ticks_to_usec(unsigned int ticks)
+{
+	unsigned int msec, rem;
+
+	division(ticks, ticks_per_msec, &msec, &rem);
+
+	return msec * 1000 + div(rem * 1000, ticks_per_msec);
 }
@@ -33,6 +33,8 @@
 #include "arch/at91_qspi.h"
 #include "spi_flash/spi_nor.h"
 #include "debug.h"
+#include "timer.h"
+#include "dma.h"
 
 #ifndef CONFIG_SYS_BASE_QSPI
 #error "CONFIG_SYS_BASE_QSPI is not set"
@@ -42,6 +44,9 @@
 #error "CONFIG_SYS_BASE_QSPI_MEM is not set"
 #endif
 
+/* The end of the instruction follows the last data access closely */
+#define QSPI_TIMEOUT_US		10000
+
 struct qspi_priv {
 	u32		reg_base;
 	void		*mem;
@@ -129,6 +134,10 @@ static int qspi_init(void *priv)
 
 	qspi_writel(qspi, QSPI_CR, QSPI_CR_QSPIEN);
 
+#ifdef CONFIG_QSPI_DMA
+	dma_init();
+#endif
+
 	return 0;
 }
 
@@ -139,9 +148,56 @@ static int qspi_cleanup(void *priv)
 	qspi_writel(qspi, QSPI_CR, QSPI_CR_QSPIDIS);
 	qspi_writel(qspi, QSPI_CR, QSPI_CR_SWRST);
 
+#ifdef CONFIG_QSPI_DMA
+	dma_cleanup();
+#endif
+
 	return 0;
 }
 
+#ifdef CONFIG_QSPI_DMA
+/* Below this, the CPU copy is over before the DMA is set up */
+#define QSPI_DMA_MIN		1024
+
+/*
+ * Large reads go from the memory window to the buffer as one XDMAC
+ * linked list transfer. The word aligned body is copied by DMA, the
+ * unaligned head and tail, or the whole read if the DMA fails, by the
+ * CPU.
+ */
+static void qspi_read(struct qspi_priv *qspi, unsigned int offset,
+		      void *buf, unsigned int len)
+{
+	unsigned char *dst = buf;
+	const unsigned char *src = (unsigned char *)qspi->mem + offset;
+	unsigned int head, body;
+
+	if ((len >= QSPI_DMA_MIN) &&
+	    !(((unsigned int)dst ^ (unsigned int)src) & 0x3)) {
+		head = -(unsigned int)dst & 0x3;
+		memcpy(dst, src, head);
+		dst += head;
+		src += head;
+		len -= head;
+
+		body = len & ~0x3;
+		if (!dma_memcpy_start(0, dst, src, body) && !dma_wait(0)) {
+			dst += body;
+			src += body;
+			len -= body;
+		}
+	}
+
+	memcpy(dst, src, len);
+}
+#else
+static void qspi_read(struct qspi_priv *qspi, unsigned int offset,
+		      void *buf, unsigned int len)
+{
+	memcpy(buf, qspi->mem + offset, len);
+}
+#endif
+
 static int qspi_init_ifr(const struct spi_flash_command *cmd,
 			 unsigned int *ifr)
 {
@@ -211,6 +267,7 @@ static int qspi_exec(void *priv, const struct spi_flash_command *cmd)
 	unsigned int iar, icr, ifr;
 	unsigned int offset;
 	unsigned int sr, imr;
+	unsigned long long deadline;
 
 	iar = 0;
 	icr = 0;
@@ -323,7 +380,7 @@ static int qspi_exec(void *priv, const struct spi_flash_command *cmd)
 		memcpy(qspi->mem + offset, cmd->tx_data, cmd->data_len);
 	else if (cmd->rx_data)
 		/* Read data. */
-		memcpy(cmd->rx_data, qspi->mem + offset, cmd->data_len);
+		qspi_read(qspi, offset, cmd->rx_data, cmd->data_len);
 	else
 		/* Stop here for continuous read */
 		return 0;
@@ -335,12 +392,170 @@ no_data:
 	/* Poll INSTruction End and Chip Select Rise flags. */
 	imr = (QSPI_SR_INSTRE | QSPI_SR_CSR);
 	sr = 0;
-	while (sr != (QSPI_SR_INSTRE | QSPI_SR_CSR))
+	deadline = timer_deadline_usec(QSPI_TIMEOUT_US);
+	while (sr != (QSPI_SR_INSTRE | QSPI_SR_CSR)) {
 		sr |= qspi_readl(qspi, QSPI_SR) & imr;
+		if (sr != imr && timer_expired(deadline)) {
+			dbg_info("QSPI: timeout, SR: %x\n", sr);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_QSPI_CALIBRATION
+/* Upper limit of QSCK, whatever the memory */
+#define QSPI_MAX_FREQ		83000000
+
+/* The start of the memory, read back twice for each setting */
+#define QSPI_CALIB_LEN		256
+#define QSPI_CALIB_TRIES	2
+
+#ifdef CONFIG_QSPI_CALIBRATION_BUREG
+/*
+ * The setting is saved with the JEDEC manufacturer and device ID bytes
+ * of the memory it was found for: [31:8] ID, [7] DLYBS/DLYCS, [6:0] SCBR.
+ */
+#define QSPI_CALIB_BUREG	(AT91C_BASE_BUREG + 3 * 4)
+#define QSPI_CALIB_ID		0xffffff00
+#define QSPI_CALIB_DLY		(0x1 << 7)
+#define QSPI_CALIB_SCBR		0x7f
+
+static unsigned int qspi_calib_id(const struct spi_flash *flash)
+{
+	return ((unsigned int)flash->id[0] << 24)
+		| ((unsigned int)flash->id[1] << 16)
+		| ((unsigned int)flash->id[2] << 8);
+}
+#endif
+
+static void qspi_set_timings(struct qspi_priv *qspi,
+			     unsigned int scbr, unsigned int dly)
+{
+	unsigned int reg;
+
+	reg = qspi_readl(qspi, QSPI_SCR);
+	reg &= ~(QSPI_SCR_SCBR | QSPI_SCR_DLYBS);
+	reg |= QSPI_SCR_SCBR_(scbr) | QSPI_SCR_DLYBS_(dly);
+	qspi_writel(qspi, QSPI_SCR, reg);
+
+	reg = qspi_readl(qspi, QSPI_MR);
+	reg &= ~QSPI_MR_DLYCS;
+	reg |= QSPI_MR_DLYCS_(dly);
+	qspi_writel(qspi, QSPI_MR, reg);
+}
+
+static int qspi_check_timings(struct spi_flash *flash,
+			      unsigned int scbr, unsigned int dly,
+			      const u8 *ref, u8 *buf)
+{
+	int i;
+
+	qspi_set_timings(spi_flash_get_priv(flash), scbr, dly);
+
+	for (i = 0; i < QSPI_CALIB_TRIES; i++) {
+		memset(buf, ~ref[0], QSPI_CALIB_LEN);
+		if (spi_flash_read(flash, 0, QSPI_CALIB_LEN, buf))
+			return -1;
+		if (memcmp(buf, ref, QSPI_CALIB_LEN))
+			return -1;
+	}
 
 	return 0;
 }
 
+/*
+ * Raise QSCK one SCBR step at a time from the probe setting, first
+ * without then with one QSCK period of DLYBS/DLYCS, and stop at the
+ * first step where no setting reads the reference back. The last step
+ * that passed is the edge of the window: the image is read one step
+ * below it.
+ */
+static void qspi_calibrate(struct spi_flash *flash)
+{
+	struct qspi_priv *qspi = spi_flash_get_priv(flash);
+	u8 ref[QSPI_CALIB_LEN], buf[QSPI_CALIB_LEN];
+	unsigned int max_freq, min_scbr, scbr, dly;
+	unsigned int best_scbr, best_dly;
+	unsigned int safe_scbr, safe_dly;
+	unsigned int probe_scbr;
+	unsigned int i;
+#ifdef CONFIG_QSPI_CALIBRATION_BUREG
+	unsigned int id, reg;
+#endif
+
+	max_freq = min(flash->max_freq, QSPI_MAX_FREQ);
+	if (max_freq <= CONFIG_SYS_SPI_CLOCK)
+		return;
+
+	/* The reference is read at the probe frequency */
+	if (spi_flash_read(flash, 0, QSPI_CALIB_LEN, ref))
+		return;
+
+	for (i = 1; i < QSPI_CALIB_LEN; i++)
+		if (ref[i] != ref[0])
+			break;
+	if (i == QSPI_CALIB_LEN) {
+		dbg_info("QSPI: no pattern to calibrate against\n");
+		return;
+	}
+
+	probe_scbr = (qspi_readl(qspi, QSPI_SCR) & QSPI_SCR_SCBR) >> 8;
+	min_scbr = div(MASTER_CLOCK + max_freq - 1, max_freq) - 1;
+
+#ifdef CONFIG_QSPI_CALIBRATION_BUREG
+	id = qspi_calib_id(flash);
+	reg = readl(QSPI_CALIB_BUREG);
+	if ((reg & QSPI_CALIB_ID) == id) {
+		scbr = reg & QSPI_CALIB_SCBR;
+		dly = (reg & QSPI_CALIB_DLY) ? scbr + 1 : 0;
+		if (scbr >= min_scbr && scbr <= probe_scbr &&
+		    !qspi_check_timings(flash, scbr, dly, ref, buf)) {
+			safe_scbr = scbr;
+			safe_dly = dly;
+			goto done;
+		}
+	}
+#endif
+
+	best_scbr = safe_scbr = probe_scbr;
+	best_dly = safe_dly = 0;
+
+	for (scbr = probe_scbr; scbr-- > min_scbr; ) {
+		for (i = 0; i < 2; i++) {
+			dly = i ? scbr + 1 : 0;
+			if (!qspi_check_timings(flash, scbr, dly, ref, buf))
+				break;
+		}
+		if (i == 2)
+			break;
+
+		safe_scbr = best_scbr;
+		safe_dly = best_dly;
+		best_scbr = scbr;
+		best_dly = dly;
+	}
+
+	/* No step failed up to the frequency limit: no edge to keep off */
+	if (scbr + 1 == min_scbr) {
+		safe_scbr = best_scbr;
+		safe_dly = best_dly;
+	}
+
+#ifdef CONFIG_QSPI_CALIBRATION_BUREG
+	if (safe_scbr <= QSPI_CALIB_SCBR)
+		writel(id | (safe_dly ? QSPI_CALIB_DLY : 0) | safe_scbr,
+		       QSPI_CALIB_BUREG);
+done:
+#endif
+	qspi_set_timings(qspi, safe_scbr, safe_dly);
+
+	dbg_info("QSPI: clock calibrated at %d Hz\n",
+		 div(MASTER_CLOCK, safe_scbr + 1));
+}
+#endif
+
 static const struct spi_ops qspi_ops = {
 	.init		= qspi_init,
 	.cleanup	= qspi_cleanup,
@@ -382,6 +597,10 @@ int qspi_loadimage(struct image_info *image)
 		return -1;
 	}
 
+#ifdef CONFIG_QSPI_CALIBRATION
+	qspi_calibrate(&flash);
+#endif
+
 	return spi_flash_loadimage(&flash, image);
 }
 
@@ -35,6 +35,15 @@
 #include "div.h"
 #include "board.h"
 #include "pmc.h"
+#include "string.h"
+#include "mmu.h"
+#include "timer.h"
+#ifdef CONFIG_SPI_DMA
+#include "dma.h"
+#endif
+#ifdef CONFIG_SPI_NOR
+#include "spi_flash/spi_nor.h"
+#endif
 
 static inline unsigned int spi_readl(unsigned int reg)
 {
@@ -46,6 +55,28 @@ static inline void spi_writel(unsigned int reg, unsigned int value)
 	writel(value, CONFIG_SYS_BASE_SPI + reg);
 }
 
+/*
+ * With the FIFOs enabled, a 32-bit access to TDR/RDR moves several data at
+ * once: narrow the accesses so that each one moves a single byte.
+ */
+static inline void spi_write_tdr(unsigned short data)
+{
+#ifdef CONFIG_SPI_FIFO
+	writew(data, CONFIG_SYS_BASE_SPI + SPI_TDR);
+#else
+	spi_writel(SPI_TDR, data);
+#endif
+}
+
+static inline unsigned int spi_read_rdr(void)
+{
+#ifdef CONFIG_SPI_FIFO
+	return readb(CONFIG_SYS_BASE_SPI + SPI_RDR);
+#else
+	return spi_readl(SPI_RDR) & 0xffff;
+#endif
+}
+
 void at91_spi_cs_activate(void)
 {
 	pio_set_value(CONFIG_SYS_SPI_PCS, 0);
@@ -59,11 +90,19 @@ void at91_spi_cs_deactivate(void)
 void at91_spi_enable(void)
 {
 	spi_writel(SPI_CR, AT91C_SPI_SPIEN);
+
+#ifdef CONFIG_SPI_DMA
+	dma_init();
+#endif
 }
 
 void at91_spi_disable(void)
 {
 	spi_writel(SPI_CR, AT91C_SPI_SPIDIS);
+
+#ifdef CONFIG_SPI_DMA
+	dma_cleanup();
+#endif
 }
 
 int at91_spi_init(unsigned int pcs, unsigned int clock, unsigned int mode)
@@ -76,6 +115,10 @@ int at91_spi_init(unsigned int pcs, unsigned int clock, unsigned int mode)
 	spi_writel(SPI_CR, AT91C_SPI_SWRST);
 	spi_writel(SPI_CR, AT91C_SPI_SWRST);
 
+#ifdef CONFIG_SPI_FIFO
+	spi_writel(SPI_CR, AT91C_SPI_FIFOEN);
+#endif
+
 	if (pcs == AT91C_SPI_PCS0_DATAFLASH) {
 		ncs = 0;
 	} else if (pcs == AT91C_SPI_PCS1_DATAFLASH) {
@@ -122,7 +165,7 @@ void at91_spi_write_data(unsigned short data)
 {
 	while ((spi_readl(SPI_SR) & AT91C_SPI_TXEMPTY) == 0)
 		;
-	spi_writel(SPI_TDR, data);
+	spi_write_tdr(data);
 	while ((spi_readl(SPI_SR) & AT91C_SPI_TDRE) == 0)
 		;
 }
@@ -131,10 +174,373 @@ unsigned int at91_spi_read_spi(void)
 {
 	while ((spi_readl(SPI_SR) & AT91C_SPI_RDRF) == 0)
 		;
-	return spi_readl(SPI_RDR) & 0xffff;
+	return spi_read_rdr();
+}
+
+#if defined(CONFIG_SPI_FIFO) || defined(CONFIG_SPI_PDC)
+/*
+ * A read is given up after SPI_TIMEOUT_MS, plus the time to move its
+ * bytes at 64 KB/s, the rate of a 512 kHz SPI clock.
+ */
+#define SPI_TIMEOUT_MS		100
+#define SPI_TIMEOUT_RATE_SHIFT	6	/* bytes per ms, as log2 */
+
+static unsigned long long spi_read_deadline(unsigned int len)
+{
+	return timer_deadline_msec(SPI_TIMEOUT_MS
+				   + (len >> SPI_TIMEOUT_RATE_SHIFT));
+}
+#endif
+
+#if defined(CONFIG_SPI_FIFO)
+#define SPI_FIFO_SIZE		16
+
+/*
+ * Never more than one FIFO worth of bytes in flight: the RX FIFO cannot
+ * overrun, and the TX FIFO never runs dry while data is pending.
+ */
+static int spi_fifo_read(unsigned char *data, unsigned int len)
+{
+	unsigned long long deadline = spi_read_deadline(len);
+	unsigned int tx = 0, rx = 0;
+	unsigned int level;
+
+	spi_writel(SPI_CR, AT91C_SPI_TXFCLR | AT91C_SPI_RXFCLR);
+
+	while (rx < len) {
+		while ((tx < len) && ((tx - rx) < SPI_FIFO_SIZE)) {
+			spi_write_tdr(0);
+			tx++;
+		}
+
+		level = AT91C_SPI_RXFL_(spi_readl(SPI_FLR));
+		if (!level && timer_expired(deadline)) {
+			dbg_info("SPI: read timeout, %d of %d bytes\n",
+				 rx, len);
+			return -1;
+		}
+
+		while (level--)
+			data[rx++] = spi_read_rdr();
+	}
+
+	return 0;
+}
+#elif defined(CONFIG_SPI_PDC)
+/* The PDC counters are 16-bit wide */
+#define SPI_PDC_MAX		0x8000
+#define SPI_ZERO_SIZE		256
+
+/* Never written: the TX channel keeps sending it over again */
+static unsigned char spi_zero[SPI_ZERO_SIZE];
+
+static int spi_pdc_read(unsigned char *data, unsigned int len)
+{
+	unsigned long long deadline = spi_read_deadline(len);
+	unsigned int tx, rx;
+	int ret = 0;
+
+	dcache_invalidate_range((unsigned int)data, (unsigned int)data + len);
+
+	spi_writel(SPI_PTCR, AT91C_PDC_RXTDIS | AT91C_PDC_TXTDIS);
+
+	/* Drop a stale byte, it would be the first one stored */
+	spi_readl(SPI_RDR);
+
+	rx = min(len, SPI_PDC_MAX);
+	spi_writel(SPI_RPR, (unsigned int)data);
+	spi_writel(SPI_RCR, rx);
+	spi_writel(SPI_RNCR, 0);
+
+	tx = min(len, SPI_ZERO_SIZE);
+	spi_writel(SPI_TPR, (unsigned int)spi_zero);
+	spi_writel(SPI_TCR, tx);
+	spi_writel(SPI_TNCR, 0);
+
+	spi_writel(SPI_PTCR, AT91C_PDC_RXTEN | AT91C_PDC_TXTEN);
+
+	/* Refill the next buffers as soon as the PDC switches to them */
+	while ((rx < len) || (tx < len)) {
+		if ((rx < len) && !spi_readl(SPI_RNCR)) {
+			spi_writel(SPI_RNPR, (unsigned int)(data + rx));
+			spi_writel(SPI_RNCR, min(len - rx, SPI_PDC_MAX));
+			rx += min(len - rx, SPI_PDC_MAX);
+		}
+
+		if ((tx < len) && !spi_readl(SPI_TNCR)) {
+			spi_writel(SPI_TNPR, (unsigned int)spi_zero);
+			spi_writel(SPI_TNCR, min(len - tx, SPI_ZERO_SIZE));
+			tx += min(len - tx, SPI_ZERO_SIZE);
+		}
+
+		if (timer_expired(deadline)) {
+			ret = -1;
+			break;
+		}
+	}
+
+	while (!ret && ((spi_readl(SPI_SR) & AT91C_SPI_RXBUFF) == 0)) {
+		if (timer_expired(deadline))
+			ret = -1;
+	}
+
+	spi_writel(SPI_PTCR, AT91C_PDC_RXTDIS | AT91C_PDC_TXTDIS);
+
+	if (ret)
+		dbg_info("SPI: read timeout, RCR: %d\n", spi_readl(SPI_RCR));
+
+	dcache_invalidate_range((unsigned int)data, (unsigned int)data + len);
+
+	return ret;
+}
+#elif defined(CONFIG_SPI_DMA)
+/* Below this, the polled loop is over before the channels are set up */
+#define SPI_DMA_MIN		64
+/* Fits in the DMA_LIST_MAX descriptors of a channel */
+#define SPI_DMA_CHUNK		0x80000
+
+#define SPI_DMA_CHAN_RX		0
+#define SPI_DMA_CHAN_TX		1
+
+#if defined(CONFIG_SPI_BUS1)
+#define SPI_DMA_PERID_TX	AT91C_DMA_PERID_SPI1_TX
+#define SPI_DMA_PERID_RX	AT91C_DMA_PERID_SPI1_RX
+#else
+#define SPI_DMA_PERID_TX	AT91C_DMA_PERID_SPI0_TX
+#define SPI_DMA_PERID_RX	AT91C_DMA_PERID_SPI0_RX
+#endif
+
+/* Never written: the TX channel sends it for each byte received */
+static unsigned char spi_zero;
+
+/*
+ * The RX channel stores RDR into the buffer, the TX channel writes the
+ * zero byte to TDR, both paced by the SPI requests. The RX channel is
+ * started first, so that it is ready for the first byte.
+ */
+static int spi_dma_read(unsigned char *data, unsigned int len)
+{
+	unsigned int size;
+
+	/* Drop a stale byte, it would be the first one stored */
+	spi_readl(SPI_RDR);
+
+	while (len) {
+		size = min(len, SPI_DMA_CHUNK);
+
+		if (dma_per2mem_start(SPI_DMA_CHAN_RX, SPI_DMA_PERID_RX,
+				      DMA_WIDTH_BYTE,
+				      (void *)(CONFIG_SYS_BASE_SPI + SPI_RDR),
+				      data, size))
+			return -1;
+
+		if (dma_mem2per_start(SPI_DMA_CHAN_TX,
+				      SPI_DMA_PERID_TX | DMA_PERID_SRC_FIXED,
+				      DMA_WIDTH_BYTE, &spi_zero,
+				      (void *)(CONFIG_SYS_BASE_SPI + SPI_TDR),
+				      size)) {
+			dma_stop(SPI_DMA_CHAN_RX);
+			return -1;
+		}
+
+		if (dma_wait(SPI_DMA_CHAN_RX) || dma_wait(SPI_DMA_CHAN_TX)) {
+			dma_stop(SPI_DMA_CHAN_RX);
+			dma_stop(SPI_DMA_CHAN_TX);
+			return -1;
+		}
+
+		data += size;
+		len -= size;
+	}
+
+	return 0;
+}
+#endif
+
+int at91_spi_read_data(unsigned char *data, unsigned int len)
+{
+#if defined(CONFIG_SPI_FIFO)
+	return spi_fifo_read(data, len);
+#elif defined(CONFIG_SPI_PDC)
+	return spi_pdc_read(data, len);
+#else
+	unsigned int i;
+
+#if defined(CONFIG_SPI_DMA)
+	if (len >= SPI_DMA_MIN)
+		return spi_dma_read(data, len);
+#endif
+
+	for (i = 0; i < len; i++) {
+		at91_spi_write_data(0);
+		data[i] = at91_spi_read_spi();
+	}
+
+	return 0;
+#endif
 }
 
 unsigned int at91_spi_read_sr(void)
 {
 	return spi_readl(SPI_SR);
 }
+
+#ifdef CONFIG_SPI_NOR
+/* Only the SPI 1-1-1 protocol, 8 cycles per byte */
+#define SPI_CMD_MAX		(1 + 4 + 1 + 4)
+
+struct spi_priv {
+	unsigned int	clock;
+	unsigned int	mode;
+};
+
+static int spi_setup(struct spi_priv *spi)
+{
+	int ret;
+
+	ret = at91_spi_init(AT91C_SPI_PCS_DATAFLASH, spi->clock, spi->mode);
+	if (ret)
+		return ret;
+
+	at91_spi_enable();
+
+	return 0;
+}
+
+static int spi_ops_init(void *priv)
+{
+	struct spi_priv *spi = priv;
+
+	at91_spi0_hw_init();
+
+	spi->clock = CONFIG_SYS_SPI_CLOCK;
+	spi->mode = CONFIG_SYS_SPI_MODE;
+
+	return spi_setup(spi);
+}
+
+static int spi_ops_cleanup(void *priv)
+{
+	at91_spi_disable();
+
+	return 0;
+}
+
+static int spi_ops_set_freq(void *priv, u32 clock)
+{
+	struct spi_priv *spi = priv;
+
+	spi->clock = clock;
+
+	return spi_setup(spi);
+}
+
+static int spi_ops_set_mode(void *priv, u8 mode)
+{
+	struct spi_priv *spi = priv;
+
+	spi->mode = mode;
+
+	return spi_setup(spi);
+}
+
+static int spi_ops_exec(void *priv, const struct spi_flash_command *cmd)
+{
+	unsigned char buf[SPI_CMD_MAX];
+	const unsigned char *tx = cmd->tx_data;
+	unsigned char *rx = cmd->rx_data;
+	unsigned int len = 0;
+	unsigned int i;
+	int ret = 0;
+
+	if (cmd->proto != SFLASH_PROTO_1_1_1)
+		return -1;
+
+	if ((cmd->num_mode_cycles & 0x7) || (cmd->num_mode_cycles > 8) ||
+	    (cmd->num_wait_states & 0x7) || (cmd->num_wait_states > 32))
+		return -1;
+
+	if (cmd->data_len && !tx && !rx)
+		return -1;
+
+	buf[len++] = cmd->inst;
+
+	for (i = cmd->addr_len; i > 0; i--)
+		buf[len++] = (unsigned char)(cmd->addr >> (8 * (i - 1)));
+
+	if (cmd->num_mode_cycles)
+		buf[len++] = cmd->mode;
+
+	for (i = 0; i < cmd->num_wait_states; i += 8)
+		buf[len++] = 0;
+
+	at91_spi_cs_activate();
+
+	/* read spi status to clear events */
+	at91_spi_read_sr();
+
+	for (i = 0; i < len; i++) {
+		at91_spi_write_data(buf[i]);
+		at91_spi_read_spi();
+	}
+
+	if (rx && !tx) {
+		ret = at91_spi_read_data(rx, cmd->data_len);
+	} else {
+		for (i = 0; i < cmd->data_len; i++) {
+			at91_spi_write_data(tx ? tx[i] : 0);
+			if (rx)
+				rx[i] = at91_spi_read_spi();
+			else
+				at91_spi_read_spi();
+		}
+	}
+
+	at91_spi_cs_deactivate();
+
+	return ret;
+}
+
+static const struct spi_ops at91_spi_ops = {
+	.init		= spi_ops_init,
+	.cleanup	= spi_ops_cleanup,
+	.set_freq	= spi_ops_set_freq,
+	.set_mode	= spi_ops_set_mode,
+	.exec		= spi_ops_exec,
+};
+
+int spi_loadimage(struct image_info *image)
+{
+	const struct spi_flash_hwcaps hwcaps = {
+		.mask = (SFLASH_HWCAPS_READ |
+			 SFLASH_HWCAPS_READ_FAST |
+			 SFLASH_HWCAPS_PP),
+	};
+	struct spi_flash flash;
+	struct spi_priv spi;
+	int ret;
+
+	memset(&spi, 0, sizeof(spi));
+
+	memset(&flash, 0, sizeof(flash));
+	flash.ops = &at91_spi_ops;
+	spi_flash_set_priv(&flash, &spi);
+
+	/* Init the SPI controller. */
+	ret = spi_flash_init(&flash);
+	if (ret) {
+		dbg_info("SF: Fail to initialize spi\n");
+		return -1;
+	}
+
+	/* Probe the SPI flash memory. */
+	ret = spi_nor_probe(&flash, &hwcaps);
+	if (ret) {
+		dbg_info("SF: Fail to probe SPI flash\n");
+		spi_flash_cleanup(&flash);
+		return -1;
+	}
+
+	return spi_flash_loadimage(&flash, image);
+}
+#endif
@@ -31,9 +31,13 @@
 #include "div.h"
 #include "debug.h"
 #include "pmc.h"
+#include "timer.h"
 
 #define TWI_CLOCK	400000
 
+/* A few byte times, clock stretching included */
+#define TWI_TIMEOUT_US	2000
+
 unsigned int twi_init_done;
 
 unsigned char hdmi_twi_bus;
@@ -200,11 +204,22 @@ static void twi_startwrite(unsigned int twi_base, unsigned char device_addr,
 	twi_reg_write(twi_base, TWI_THR, byte);
 };
 
+static int twi_wait(unsigned int twi_base,
+		    unsigned char (*ready)(unsigned int twi_base))
+{
+	unsigned long long deadline = timer_deadline_usec(TWI_TIMEOUT_US);
+
+	while (!ready(twi_base))
+		if (timer_expired(deadline))
+			return -1;
+
+	return 0;
+}
+
 int twi_read(unsigned int bus, unsigned char device_addr,
 		unsigned int internal_addr, unsigned char iaddr_size,
 		unsigned char *data, unsigned int bytes)
 {
-	int timeout;
 	unsigned int twi_base;
 
 	twi_base = get_twi_base(bus);
@@ -219,11 +234,7 @@ int twi_read(unsigned int bus, unsigned char device_addr,
 		if (bytes == 1)
 			twi_stop(twi_base);
 
-		timeout = 10000;
-		while (!twi_check_rxrdy(twi_base) && (--timeout))
-			;
-
-		if (!timeout) {
+		if (twi_wait(twi_base, twi_check_rxrdy)) {
 			dbg_loud("twi read: timeout to wait RXRDY bit\n");
 			return -1;
 		}
@@ -232,10 +243,7 @@ int twi_read(unsigned int bus, unsigned char device_addr,
 		bytes--;
 	}
 
-	timeout = 10000;
-	while (!twi_check_txcompleted(twi_base) && (--timeout))
-		;
-	if (!timeout) {
+	if (twi_wait(twi_base, twi_check_txcompleted)) {
 		dbg_loud("twi read: timeout to wait TXCOMP bit\n");
 		return -1;
 	}
@@ -247,7 +255,6 @@ int twi_write(unsigned int bus, unsigned char device_addr,
 		unsigned int internal_addr, unsigned char iaddr_size,
 		unsigned char *data, unsigned int bytes)
 {
-	int timeout;
 	unsigned int twi_base;
 
 	twi_base = get_twi_base(bus);
@@ -259,11 +266,7 @@ int twi_write(unsigned int bus, unsigned char device_addr,
 	bytes--;
 
 	while (bytes > 0) {
-		timeout = 10000;
-		while (!twi_check_txrdy(twi_base) && (--timeout))
-			;
-
-		if (!timeout) {
+		if (twi_wait(twi_base, twi_check_txrdy)) {
 			dbg_loud("twi write: timeout to wait TXRDY bit\n");
 			return -1;
 		}
@@ -275,10 +278,7 @@ int twi_write(unsigned int bus, unsigned char device_addr,
 	twi_stop(twi_base);
 
 
-	timeout = 10000;
-	while (!twi_check_txcompleted(twi_base) && (--timeout))
-		;
-	if (!timeout) {
+	if (twi_wait(twi_base, twi_check_txcompleted)) {
 		dbg_loud("twi write: timeout to wait TXCOMP bit\n");
 		return -1;
 	}
@@ -28,6 +28,7 @@
 #include "hardware.h"
 #include "board.h"
 #include "arch/at91_dbgu.h"
+#include "usart.h"
 
 #ifndef USART_BASE
 #define USART_BASE	AT91C_BASE_DBGU
@@ -67,6 +68,48 @@ void usart_init(unsigned int baudrate)
 	write_usart(DBGU_CR, AT91C_DBGU_RXEN | AT91C_DBGU_TXEN);
 }
 
+#ifdef CONFIG_USART_TX_BUFFER
+/*
+ * The output goes to a ring buffer in SRAM, rather than waiting for the
+ * transmitter after each character. usart_poll() hands the transmitter
+ * what it can take right away: it is called by usart_puts() and from
+ * the busy-wait loops (delays, NAND ready, SD transfers). usart_flush()
+ * sends everything before the jump. When the buffer is full, the caller
+ * waits for room, so no output is lost.
+ */
+#define TX_BUFFER_SIZE	1024	/* power of 2 */
+
+static char tx_buffer[TX_BUFFER_SIZE];
+static unsigned int tx_head;	/* next character to queue */
+static unsigned int tx_tail;	/* next character to send */
+
+void usart_poll(void)
+{
+	while ((tx_tail != tx_head)
+	    && (read_usart(DBGU_CSR) & AT91C_DBGU_TXRDY)) {
+		write_usart(DBGU_THR, tx_buffer[tx_tail & (TX_BUFFER_SIZE - 1)]);
+		tx_tail++;
+	}
+}
+
+void usart_flush(void)
+{
+	while (tx_tail != tx_head)
+		usart_poll();
+
+	while (!(read_usart(DBGU_CSR) & AT91C_DBGU_TXEMPTY))
+		;
+}
+
+static void usart_putc(const char c)
+{
+	while ((tx_head - tx_tail) >= TX_BUFFER_SIZE)
+		usart_poll();
+
+	tx_buffer[tx_head & (TX_BUFFER_SIZE - 1)] = c;
+	tx_head++;
+}
+#else
 static void usart_putc(const char c)
 {
 	while (!(read_usart(DBGU_CSR) & AT91C_DBGU_TXRDY))
@@ -74,6 +117,7 @@ static void usart_putc(const char c)
 
 	write_usart(DBGU_THR, c);
 }
+#endif
 
 void usart_puts(const char *ptr)
 {
@@ -85,6 +129,8 @@ void usart_puts(const char *ptr)
 		usart_putc(ptr[i]);
 		i++;
 	}
+
+	usart_poll();
 }
 
 char usart_getc(void)
@@ -0,0 +1,251 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2017, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hardware.h"
+#include "board.h"
+#include "pmc.h"
+#include "arch/at91_xdmac.h"
+#include "dma.h"
+#include "mmu.h"
+#include "timer.h"
+#include "debug.h"
+
+#if defined(AT91C_BASE_XDMAC0)
+#define XDMAC_BASE	AT91C_BASE_XDMAC0
+#else
+#define XDMAC_BASE	AT91C_BASE_DMAC0
+#endif
+
+/* AHB interfaces: memories on IF0, peripherals on IF1 */
+#define XDMAC_MEM_IF	0
+#define XDMAC_PER_IF	1
+
+/* A disabled channel first flushes its FIFO */
+#define XDMAC_STOP_TIMEOUT_US	1000
+
+/* Linked list descriptor, view 1: the channel configuration is kept */
+struct xdmac_desc {
+	unsigned int	mbr_nda;
+	unsigned int	mbr_ubc;
+	unsigned int	mbr_sa;
+	unsigned int	mbr_da;
+};
+
+static struct xdmac_desc xdmac_desc[DMA_CHANNELS][DMA_LIST_MAX]
+					__attribute__((aligned(32)));
+
+static inline unsigned int xdmac_readl(unsigned int reg)
+{
+	return readl(XDMAC_BASE + reg);
+}
+
+static inline void xdmac_writel(unsigned int reg, unsigned int value)
+{
+	writel(value, XDMAC_BASE + reg);
+}
+
+static inline unsigned int xdmac_ch_readl(unsigned int chan, unsigned int reg)
+{
+	return readl(XDMAC_BASE + XDMAC_CH(chan) + reg);
+}
+
+static inline void xdmac_ch_writel(unsigned int chan,
+				   unsigned int reg,
+				   unsigned int value)
+{
+	writel(value, XDMAC_BASE + XDMAC_CH(chan) + reg);
+}
+
+void dma_init(void)
+{
+	unsigned int chan;
+
+	pmc_enable_periph_clock(AT91C_ID_XDMAC0);
+
+	for (chan = 0; chan < DMA_CHANNELS; chan++) {
+		dma_stop(chan);
+		xdmac_ch_writel(chan, XDMAC_CID, 0xffffffff);
+	}
+}
+
+void dma_cleanup(void)
+{
+	unsigned int chan;
+
+	for (chan = 0; chan < DMA_CHANNELS; chan++)
+		dma_stop(chan);
+
+	pmc_disable_periph_clock(AT91C_ID_XDMAC0);
+}
+
+int dma_hw_start(unsigned int chan,
+		 unsigned int perid,
+		 unsigned int width,
+		 const struct dma_xfer *list,
+		 unsigned int count)
+{
+	struct xdmac_desc *desc = xdmac_desc[chan];
+	unsigned int max = XDMAC_CUBC_UBLEN_MAX << width;
+	unsigned int id = perid & DMA_PERID_MASK;
+	unsigned int src_incr, dst_incr;
+	unsigned int src, dst, len, size;
+	unsigned int cc;
+	unsigned int i, n = 0;
+
+	if (perid == DMA_PERID_NONE) {
+		src_incr = 1;
+		dst_incr = 1;
+	} else if (perid & DMA_PERID_MEM2PER) {
+		src_incr = !(perid & DMA_PERID_SRC_FIXED);
+		dst_incr = 0;
+	} else {
+		src_incr = 0;
+		dst_incr = 1;
+	}
+
+	for (i = 0; i < count; i++) {
+		src = list[i].src;
+		dst = list[i].dst;
+		len = list[i].len;
+
+		while (len) {
+			if (n == DMA_LIST_MAX)
+				return -1;
+
+			size = (len > max) ? max : len;
+
+			desc[n].mbr_nda = (unsigned int)&desc[n + 1];
+			desc[n].mbr_ubc = XDMAC_MBR_UBC_UBLEN(size >> width)
+					| XDMAC_MBR_UBC_NDE
+					| XDMAC_MBR_UBC_NSEN
+					| XDMAC_MBR_UBC_NDEN
+					| XDMAC_MBR_UBC_NVIEW_NDV1;
+			desc[n].mbr_sa = src;
+			desc[n].mbr_da = dst;
+			n++;
+
+			if (src_incr)
+				src += size;
+			if (dst_incr)
+				dst += size;
+			len -= size;
+		}
+	}
+
+	if (!n)
+		return -1;
+
+	desc[n - 1].mbr_nda = 0;
+	desc[n - 1].mbr_ubc &= ~XDMAC_MBR_UBC_NDE;
+
+	dcache_clean_range((unsigned int)desc, (unsigned int)&desc[n]);
+
+	if (perid == DMA_PERID_NONE)
+		cc = XDMAC_CC_TYPE_MEM_TRAN
+			| XDMAC_CC_MBSIZE_SIXTEEN
+			| XDMAC_CC_SWREQ_SWR_CONNECTED
+			| XDMAC_CC_CSIZE_CHK_1
+			| XDMAC_CC_DWIDTH(width)
+			| XDMAC_CC_SIF(XDMAC_MEM_IF)
+			| XDMAC_CC_DIF(XDMAC_MEM_IF)
+			| XDMAC_CC_SAM_INCREMENTED_AM
+			| XDMAC_CC_DAM_INCREMENTED_AM;
+	else if (perid & DMA_PERID_MEM2PER)
+		cc = XDMAC_CC_TYPE_PER_TRAN
+			| XDMAC_CC_MBSIZE_SIXTEEN
+			| XDMAC_CC_DSYNC_MEM2PER
+			| XDMAC_CC_SWREQ_HWR_CONNECTED
+			| XDMAC_CC_CSIZE_CHK_1
+			| XDMAC_CC_DWIDTH(width)
+			| XDMAC_CC_SIF(XDMAC_MEM_IF)
+			| XDMAC_CC_DIF(XDMAC_PER_IF)
+			| (src_incr ? XDMAC_CC_SAM_INCREMENTED_AM
+				    : XDMAC_CC_SAM_FIXED_AM)
+			| XDMAC_CC_DAM_FIXED_AM
+			| XDMAC_CC_PERID(id);
+	else
+		cc = XDMAC_CC_TYPE_PER_TRAN
+			| XDMAC_CC_MBSIZE_SIXTEEN
+			| XDMAC_CC_DSYNC_PER2MEM
+			| XDMAC_CC_SWREQ_HWR_CONNECTED
+			| XDMAC_CC_CSIZE_CHK_1
+			| XDMAC_CC_DWIDTH(width)
+			| XDMAC_CC_SIF(XDMAC_PER_IF)
+			| XDMAC_CC_DIF(XDMAC_MEM_IF)
+			| XDMAC_CC_SAM_FIXED_AM
+			| XDMAC_CC_DAM_INCREMENTED_AM
+			| XDMAC_CC_PERID(id);
+
+	/* Clear the status left by a previous transfer */
+	xdmac_ch_readl(chan, XDMAC_CIS);
+
+	xdmac_ch_writel(chan, XDMAC_CC, cc);
+	xdmac_ch_writel(chan, XDMAC_CUBC, 0);
+	xdmac_ch_writel(chan, XDMAC_CBC, 0);
+	xdmac_ch_writel(chan, XDMAC_CDS_MSP, 0);
+	xdmac_ch_writel(chan, XDMAC_CSUS, 0);
+	xdmac_ch_writel(chan, XDMAC_CDUS, 0);
+	xdmac_ch_writel(chan, XDMAC_CNDA,
+			(unsigned int)desc | XDMAC_CNDA_NDAIF(XDMAC_MEM_IF));
+	xdmac_ch_writel(chan, XDMAC_CNDC,
+			XDMAC_CNDC_NDE
+			| XDMAC_CNDC_NDSUP
+			| XDMAC_CNDC_NDDUP
+			| XDMAC_CNDC_NDVIEW_NDV1);
+
+	xdmac_writel(XDMAC_GE, 1 << chan);
+
+	return 0;
+}
+
+int dma_poll(unsigned int chan)
+{
+	if (xdmac_ch_readl(chan, XDMAC_CIS) & XDMAC_CIS_ERRORS)
+		return -1;
+
+	if (xdmac_readl(XDMAC_GS) & (1 << chan))
+		return 0;
+
+	return 1;
+}
+
+void dma_stop(unsigned int chan)
+{
+	unsigned long long deadline;
+
+	xdmac_writel(XDMAC_GD, 1 << chan);
+
+	deadline = timer_deadline_usec(XDMAC_STOP_TIMEOUT_US);
+	while (xdmac_readl(XDMAC_GS) & (1 << chan)) {
+		if (timer_expired(deadline)) {
+			dbg_info("DMA: channel %d: cannot be stopped\n", chan);
+			break;
+		}
+	}
+
+	xdmac_ch_readl(chan, XDMAC_CIS);
+}
@@ -0,0 +1,162 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2017, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "common.h"
+#include "hardware.h"
+#include "board.h"
+#include "bootstage.h"
+#include "timer.h"
+#include "fdt.h"
+#include "string.h"
+#include "debug.h"
+
+#define BOOTSTAGE_MAX		24
+#define BOOTSTAGE_NAMES_LEN	256
+
+/*
+ * The time of each stage is taken from the PIT, which runs from
+ * timer_init() on. On the Cortex-A5 the PMU cycle counter is recorded
+ * too, for the cost of the short stages.
+ */
+struct bootstage_record {
+	const char	*name;
+	unsigned int	ticks;
+#ifdef CORE_CORTEX_A5
+	unsigned int	cycles;
+#endif
+};
+
+static struct bootstage_record bootstage[BOOTSTAGE_MAX];
+static unsigned int bootstage_count;
+
+#ifdef CORE_CORTEX_A5
+#define PMCR_E		(1 << 0)	/* enable the counters */
+#define PMCR_C		(1 << 2)	/* reset the cycle counter */
+#define PMCNTEN_C	(1 << 31)
+
+static void pmu_cycle_counter_enable(void)
+{
+	unsigned int pmcr;
+
+	asm volatile ("mrc	p15, 0, %0, c9, c12, 0" : "=r" (pmcr));
+	pmcr |= PMCR_E | PMCR_C;
+	asm volatile ("mcr	p15, 0, %0, c9, c12, 0" : : "r" (pmcr));
+	asm volatile ("mcr	p15, 0, %0, c9, c12, 1" : : "r" (PMCNTEN_C));
+}
+
+static unsigned int pmu_cycle_counter(void)
+{
+	unsigned int cycles;
+
+	asm volatile ("mrc	p15, 0, %0, c9, c13, 0" : "=r" (cycles));
+
+	return cycles;
+}
+#endif
+
+void bootstage_mark(const char *name)
+{
+	struct bootstage_record *record;
+
+	if (bootstage_count >= BOOTSTAGE_MAX)
+		return;
+
+	record = &bootstage[bootstage_count++];
+	record->name = name;
+	record->ticks = timer_get_ticks();
+#ifdef CORE_CORTEX_A5
+	if (bootstage_count == 1)
+		pmu_cycle_counter_enable();
+
+	record->cycles = pmu_cycle_counter();
+#endif
+}
+
+void bootstage_report(void)
+{
+	struct bootstage_record *record;
+	unsigned int last = 0;
+	unsigned int usec;
+	unsigned int i;
+
+	dbg_info("\nBoot stages:\n");
+
+	for (i = 0; i < bootstage_count; i++) {
+		record = &bootstage[i];
+		usec = timer_ticks_to_usec(record->ticks);
+
+		dbg_info("  %s: %u us (+%u us)", record->name,
+			 usec, usec - last);
+#ifdef CORE_CORTEX_A5
+		if (i)
+			dbg_info(", %u cycles",
+				 record->cycles - bootstage[i - 1].cycles);
+#endif
+		dbg_info("\n");
+
+		last = usec;
+	}
+}
+
+#ifdef CONFIG_OF_LIBFDT
+/*
+ * The stages are exported in the /chosen node, as a list of names and
+ * the matching times in us since timer_init():
+ *	at91bootstrap,bootstage-names = "hw_init", "ddr", ...;
+ *	at91bootstrap,bootstage-us = <1800 1450 ...>;
+ */
+int bootstage_fixup_fdt(void *blob)
+{
+	char names[BOOTSTAGE_NAMES_LEN];
+	unsigned int usec[BOOTSTAGE_MAX];
+	unsigned int names_len = 0;
+	unsigned int len;
+	unsigned int i;
+	int ret;
+
+	for (i = 0; i < bootstage_count; i++) {
+		len = strlen(bootstage[i].name) + 1;
+		if (names_len + len > sizeof(names))
+			break;
+
+		memcpy(names + names_len, bootstage[i].name, len);
+		names_len += len;
+		usec[i] = swap_uint32(timer_ticks_to_usec(bootstage[i].ticks));
+	}
+
+	if (!i)
+		return 0;
+
+	ret = fixup_chosen_property(blob, "at91bootstrap,bootstage-names",
+				    names, names_len);
+	if (ret)
+		return ret;
+
+	return fixup_chosen_property(blob, "at91bootstrap,bootstage-us",
+				     usec, i * sizeof(usec[0]));
+}
+#endif
@@ -136,10 +136,12 @@ void load_image_done(int retval)
 	}
 	if (retval == -1) {
 		usart_puts("Failed to load image\n");
+		usart_flush();
 		while(1);
 	}
 	if (retval == -2) {
 		usart_puts("Success to recovery\n");
+		usart_flush();
 		while (1);
 	}
 }
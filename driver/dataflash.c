@@ -34,8 +34,12 @@ int load_dataflash(struct image_info *image)
 	int ret = 0;
 
 #ifdef CONFIG_SPI
+#ifdef CONFIG_SPI_NOR
+	ret = spi_loadimage(image);
+#else
 	ret = spi_flash_loadimage(image);
 #endif
+#endif
 
 #ifdef CONFIG_QSPI
 	ret = qspi_loadimage(image);
@@ -27,12 +27,16 @@
  * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 #include "hardware.h"
+#include "board.h"
 #include "arch/at91_ddrsdrc.h"
 #include "arch/at91_sfr.h"
 #include "backup.h"
+#include "usart.h"
 #include "debug.h"
+#include "div.h"
 #include "ddramc.h"
 #include "timer.h"
+#include "bootstage.h"
 
 /* write DDRC register */
 static void write_ddramc(unsigned int address,
@@ -51,7 +55,197 @@ static unsigned int read_ddramc(unsigned int address, unsigned int offset)
 }
 #endif
 
+/*
+ * The delays of the initialization sequences, in ns: the minimums of
+ * the JEDEC standards for the largest densities, those given in clock
+ * cycles being converted at the bus speed.
+ */
+struct ddram_init_delays {
+	unsigned int	tinit;		/* power and clock stable, to CKE high */
+	unsigned int	tinit1;		/* LPDDR2/3: CKE low, to the first NOP */
+	unsigned int	tinit5;		/* LPDDR2/3: auto-initialization */
+	unsigned int	txpr;		/* CKE high, to the first command */
+	unsigned int	tmrd;		/* mode register set, to a command */
+	unsigned int	trpa;		/* precharge all */
+	unsigned int	trfc;		/* auto-refresh */
+	unsigned int	tdllk;		/* DLL lock */
+	unsigned int	tzqinit;	/* initial ZQ calibration */
+};
+
+#define DDRAM_MCK_MHZ		(MASTER_CLOCK / 1000000)
+#define DDRAM_NCK(nck)		(((nck) * 1000 + DDRAM_MCK_MHZ - 1) / DDRAM_MCK_MHZ)
+#define DDRAM_MAX(a, b)		((a) > (b) ? (a) : (b))
+
+#if (BOOTSTRAP_DEBUG_LEVEL >= DEBUG_LOUD)
+static unsigned int ddram_init_ticks;
+static unsigned int ddram_delays_ns;
+#endif
+
+static void ddram_init_begin(void)
+{
+#if (BOOTSTRAP_DEBUG_LEVEL >= DEBUG_LOUD)
+	ddram_init_ticks = timer_get_ticks();
+	ddram_delays_ns = 0;
+#endif
+}
+
+static void ddram_delay(unsigned int nsec)
+{
+	ndelay(nsec);
+#if (BOOTSTRAP_DEBUG_LEVEL >= DEBUG_LOUD)
+	ddram_delays_ns += nsec;
+#endif
+}
+
+#if defined(CONFIG_DDR_SIZE_DETECT) || defined(CONFIG_DDR_MEMTEST)
+/* The size addressed by the geometry programmed in the controller */
+static unsigned int ddram_geometry_size(struct ddramc_register *ddramc_config)
+{
+	unsigned int cr = ddramc_config->cr;
+	unsigned int shift;
+
+	shift = 9 + (cr & AT91C_DDRC2_NC);		/* columns */
+	shift += 11 + ((cr & AT91C_DDRC2_NR) >> 2);	/* rows */
+	shift += (cr & AT91C_DDRC2_NB_BANKS) ? 3 : 2;	/* banks */
+	shift += ((ddramc_config->mdr & AT91C_DDRC2_DBW)
+		  == AT91C_DDRC2_DBW_16_BITS) ? 1 : 2;	/* bus width */
+
+	return 1UL << shift;
+}
+#endif
+
+#ifdef CONFIG_DDR_SIZE_DETECT
+static unsigned int ddram_size;
+
+unsigned int ddram_get_size(void)
+{
+	return ddram_size ? ddram_size : MEM_SIZE;
+}
+
+/*
+ * Tag each power of two offset from the top down, and the base last:
+ * on a device smaller than the geometry, the first offset which does
+ * not read its tag back aliases the base, and is the size.
+ */
+static unsigned int ddram_probe_size(unsigned int ram_address,
+				     unsigned int max_size)
+{
+	volatile unsigned int *base = (volatile unsigned int *)ram_address;
+	unsigned int save[32];
+	unsigned int size, offset, i = 0;
+
+	for (size = max_size >> 1; size >= sizeof(unsigned int); size >>= 1) {
+		save[i++] = base[size >> 2];
+		base[size >> 2] = ~size;
+	}
+	save[i] = *base;
+	*base = 0;
+
+	if (*base) {
+		size = 0;
+	} else {
+		for (size = sizeof(unsigned int); size < max_size; size <<= 1)
+			if (base[size >> 2] != ~size)
+				break;
+	}
+
+	/* Restore in the reverse order, so that the aliases end up right */
+	*base = save[i];
+	for (offset = sizeof(unsigned int); i; offset <<= 1)
+		base[offset >> 2] = save[--i];
+
+	return size;
+}
+#endif
+
+#ifdef CONFIG_DDR_MEMTEST
+#define DDR_MARCH_PATTERN	0xaaaa5555
+
+extern void ddr_march_fill(unsigned int *start, unsigned int *end,
+			   unsigned int pattern);
+extern unsigned int *ddr_march_up(unsigned int *start, unsigned int *end,
+				  unsigned int expect, unsigned int pattern);
+extern unsigned int *ddr_march_down(unsigned int *start, unsigned int *end,
+				    unsigned int expect, unsigned int pattern);
+
+/* March: up(w0); up(r0, w1); down(r1, w0); up(r0) */
+static int ddram_march_test(unsigned int ram_address, unsigned int size)
+{
+	unsigned int *start = (unsigned int *)ram_address;
+	unsigned int *end = (unsigned int *)(ram_address + size);
+	unsigned int *fail;
+
+	ddr_march_fill(start, end, DDR_MARCH_PATTERN);
+
+	fail = ddr_march_up(start, end,
+			    DDR_MARCH_PATTERN, ~DDR_MARCH_PATTERN);
+	if (!fail)
+		fail = ddr_march_down(start, end,
+				      ~DDR_MARCH_PATTERN, DDR_MARCH_PATTERN);
+	if (!fail)
+		fail = ddr_march_up(start, end,
+				    DDR_MARCH_PATTERN, DDR_MARCH_PATTERN);
+
+	if (fail) {
+		dbg_info("DDR: march test failed in the burst at %x\n",
+			 (unsigned int)fail);
+		return -1;
+	}
+
+	return 0;
+}
+#endif
+
+/* Called at the end of each of the initialization sequences */
+static void ddram_init_done(unsigned int ram_address,
+			    struct ddramc_register *ddramc_config)
+{
+#if defined(CONFIG_DDR_SIZE_DETECT) || defined(CONFIG_DDR_MEMTEST)
+	unsigned int size = ddram_geometry_size(ddramc_config);
+#endif
+
+	bootstage_mark("ddr");
+
+#if (BOOTSTRAP_DEBUG_LEVEL >= DEBUG_LOUD)
+	dbg_loud("DDR: initialized in %d us, %d us of delays\n",
+		 timer_ticks_to_usec(timer_get_ticks() - ddram_init_ticks),
+		 div(ddram_delays_ns, 1000));
+#endif
+
+#ifdef CONFIG_DDR_SIZE_DETECT
+	ddram_size = ddram_probe_size(ram_address, size);
+	if (ddram_size) {
+		dbg_info("DDR: %d MB detected\n", ddram_size >> 20);
+		size = ddram_size;
+	} else {
+		dbg_info("DDR: no memory detected\n");
+	}
+#endif
+
+#ifdef CONFIG_DDR_MEMTEST
+	/* The content of the memory is kept across the backup mode */
+	if (!backup_resume()) {
+		if (ddram_march_test(ram_address, size)) {
+			dbg_info("DDR: stop the boot\n");
+			usart_flush();
+			while (1)
+				;
+		}
+		bootstage_mark("ddr_test");
+	}
+#endif
+}
+
 #ifdef CONFIG_DDR2
+static const struct ddram_init_delays ddram_delays = {
+	.tinit		= 200000,
+	.txpr		= 400,
+	.tmrd		= DDRAM_NCK(2),
+	.trpa		= 15 + DDRAM_NCK(1),
+	.trfc		= 328,			/* 4 Gb */
+	.tdllk		= DDRAM_NCK(200),
+};
+
 static int ddramc_decodtype_is_seq(unsigned int ddramc_cr)
 {
 #if defined(AT91SAM9X5) || defined(AT91SAM9N12) || defined(SAMA5D3X) \
@@ -69,6 +263,8 @@ int ddram_initialize(unsigned int base_address,
 	unsigned int ba_offset;
 	unsigned int cr = 0;
 
+	ddram_init_begin();
+
 	/* compute BA[] offset according to CR configuration */
 	ba_offset = (ddramc_config->cr & AT91C_DDRC2_NC) + 9;
 	if (ddramc_decodtype_is_seq(ddramc_config->cr))
@@ -100,9 +296,8 @@ int ddram_initialize(unsigned int base_address,
 	*((unsigned volatile int *)ram_address) = 0;
 	/* Now, clocks which drive the DDR2-SDRAM device are enabled */
 
-	/* A minimum pause wait 200 us is provided to precede any signal toggle.
-	(6 core cycles per iteration, core is at 396MHz: min 13340 loops) */
-	udelay(200);
+	/* A minimum pause wait 200 us is provided to precede any signal toggle */
+	ddram_delay(ddram_delays.tinit);
 
 	/*
 	 * Step 4:  An NOP command is issued to the DDR2-SDRAM
@@ -111,7 +306,7 @@ int ddram_initialize(unsigned int base_address,
 	*((unsigned volatile int *)ram_address) = 0;
 	/* Now, CKE is driven high */
 	/* wait 400 ns min */
-	udelay(1);
+	ddram_delay(ddram_delays.txpr);
 
 	/*
 	 * Step 5: An all banks precharge command is issued to the DDR2-SDRAM.
@@ -120,7 +315,7 @@ int ddram_initialize(unsigned int base_address,
 	*((unsigned volatile int *)ram_address) = 0;
 
 	/* wait 2 cycles min (of tCK) = 15 ns min */
-	udelay(1);
+	ddram_delay(ddram_delays.trpa);
 
 	/*
 	 * Step 6: An Extended Mode Register set(EMRS2) cycle is issued to chose between commercial or high
@@ -132,7 +327,7 @@ int ddram_initialize(unsigned int base_address,
 	*((unsigned int *)(ram_address + (0x2 << ba_offset))) = 0;
 
 	/* wait 2 cycles min (of tCK) = 15 ns min */
-	udelay(1);
+	ddram_delay(ddram_delays.tmrd);
 
 	/*
 	 * Step 7: An Extended Mode Register set(EMRS3) cycle is issued
@@ -144,7 +339,7 @@ int ddram_initialize(unsigned int base_address,
 	*((unsigned int *)(ram_address + (0x3 << ba_offset))) = 0;
 
 	/* wait 2 cycles min (of tCK) = 15 ns min */
-	udelay(1);
+	ddram_delay(ddram_delays.tmrd);
 
 	/*
 	 * Step 8: An Extened Mode Register set(EMRS1) cycle is issued to enable DLL,
@@ -156,7 +351,7 @@ int ddram_initialize(unsigned int base_address,
 	*((unsigned int *)(ram_address + (0x1 << ba_offset))) = 0;
 
 	/* An additional 200 cycles of clock are required for locking DLL */
-	udelay(1);
+	ddram_delay(ddram_delays.tmrd);
 
 	/*
 	 * Step 9: Program DLL field into the Configuration Register to high(Enable DLL reset)
@@ -173,7 +368,7 @@ int ddram_initialize(unsigned int base_address,
 	*((unsigned int *)(ram_address + (0x0 << ba_offset))) = 0;
 
 	/* wait 2 cycles min (of tCK) = 15 ns min */
-	udelay(1);
+	ddram_delay(ddram_delays.tmrd);
 
 	/*
 	 * Step 11: An all banks precharge command is issued to the DDR2-SDRAM.
@@ -181,8 +376,8 @@ int ddram_initialize(unsigned int base_address,
 	write_ddramc(base_address, HDDRSDRC2_MR, AT91C_DDRC2_MODE_PRCGALL_CMD);
 	*(((unsigned volatile int *)ram_address)) = 0;
 
-	/* wait 400 ns min (not needed on certain DDR2 devices) */
-	udelay(1);
+	/* wait TRPA min */
+	ddram_delay(ddram_delays.trpa);
 
 	/*
 	 * Step 12: Two auto-refresh (CBR) cycles are provided.
@@ -191,15 +386,15 @@ int ddram_initialize(unsigned int base_address,
 	write_ddramc(base_address, HDDRSDRC2_MR, AT91C_DDRC2_MODE_RFSH_CMD);
 	*(((unsigned volatile int *)ram_address)) = 0;
 
-	/* wait TRFC cycles min (135 ns min) extended to 400 ns */
-	udelay(1);
+	/* wait TRFC cycles min */
+	ddram_delay(ddram_delays.trfc);
 
 	/* Set 2nd CBR */
 	write_ddramc(base_address, HDDRSDRC2_MR, AT91C_DDRC2_MODE_RFSH_CMD);
 	*(((unsigned volatile int *)ram_address)) = 0;
 
-	/* wait TRFC cycles min (135 ns min) extended to 400 ns */
-	udelay(1);
+	/* wait TRFC cycles min */
+	ddram_delay(ddram_delays.trfc);
 
 	/*
 	 * Step 13: Program DLL field into the Configuration Register to low(Disable DLL reset).
@@ -218,7 +413,7 @@ int ddram_initialize(unsigned int base_address,
 	*((unsigned int *)(ram_address + (0x0 << ba_offset))) = 0;
 
 	/* wait 2 cycles min (of tCK) = 15 ns min */
-	udelay(1);
+	ddram_delay(ddram_delays.tmrd);
 
 	/*
 	 * Step 15: Program OCD field into the Configuration Register
@@ -228,7 +423,7 @@ int ddram_initialize(unsigned int base_address,
 	write_ddramc(base_address, HDDRSDRC2_CR, cr | AT91C_DDRC2_OCD_DEFAULT);
 
 	/* wait 2 cycles min (of tCK) = 15 ns min */
-	udelay(1);
+	ddram_delay(ddram_delays.tmrd);
 
 	/*
 	 * Step 16: An Extended Mode Register set (EMRS1) cycle is issued to OCD default value.
@@ -239,7 +434,7 @@ int ddram_initialize(unsigned int base_address,
 	*((unsigned int *)(ram_address + (0x1 << ba_offset))) = 0;
 
 	/* wait 2 cycles min (of tCK) = 15 ns min */
-	udelay(1);
+	ddram_delay(ddram_delays.tmrd);
 
 	/*
 	 * Step 17: Program OCD field into the Configuration Register
@@ -249,7 +444,7 @@ int ddram_initialize(unsigned int base_address,
 	write_ddramc(base_address, HDDRSDRC2_CR, cr & (~AT91C_DDRC2_OCD_DEFAULT));
 
 	/* wait 2 cycles min (of tCK) = 15 ns min */
-	udelay(1);
+	ddram_delay(ddram_delays.tmrd);
 
 	/*
 	 * Step 18: An Extended Mode Register set (EMRS1) cycle is issued to enable OCD exit.
@@ -260,7 +455,7 @@ int ddram_initialize(unsigned int base_address,
 	*((unsigned int *)(ram_address + (0x1 << ba_offset))) = 0;
 
 	/* wait 2 cycles min (of tCK) = 15 ns min */
-	udelay(1);
+	ddram_delay(ddram_delays.tmrd);
 
 	/*
 	 * Step 19: A Nornal mode command is provided.
@@ -280,14 +475,22 @@ int ddram_initialize(unsigned int base_address,
 
 	/*
 	 * Now we are ready to work on the DDRSDR
-	 *  wait for end of calibration
+	 *  wait for the DLL to lock, 200 cycles after its reset
 	 */
-	udelay(10);
+	ddram_delay(ddram_delays.tdllk);
+
+	ddram_init_done(ram_address, ddramc_config);
 
 	return 0;
 }
 
 #elif defined(CONFIG_LPDDR2)
+static const struct ddram_init_delays ddram_delays = {
+	.tinit		= 200000,		/* tINIT3 */
+	.tinit1		= 100,
+	.tinit5		= 10000,
+	.tzqinit	= 1000,
+};
 
 /*
  * This is the sama5d2-compatible initialization sequence for LP-DDR2
@@ -301,6 +504,8 @@ int lpddr2_sdram_initialize(unsigned int base_address,
 {
 	unsigned int reg;
 
+	ddram_init_begin();
+
 	write_ddramc(base_address,
 		     MPDDRC_LPDDR2_LPR, ddramc_config->lpddr2_lpr);
 
@@ -337,7 +542,7 @@ int lpddr2_sdram_initialize(unsigned int base_address,
 	 * Step 4: A pause of at least 100 ns must be observed before
 	 * a single toggle.
 	 */
-	udelay(1);
+	ddram_delay(ddram_delays.tinit1);
 
 	/*
 	 * Step 5: A NOP command is issued to the low-power DDR2-SDRAM.
@@ -350,7 +555,7 @@ int lpddr2_sdram_initialize(unsigned int base_address,
 	 * Step 6: A pause of at least 200 us must be observed before a Reset
 	 * Command.
 	 */
-	udelay(200);
+	ddram_delay(ddram_delays.tinit);
 
 	/*
 	 * Step 7: A Reset command is issued to the low-power DDR2-SDRAM.
@@ -364,7 +569,7 @@ int lpddr2_sdram_initialize(unsigned int base_address,
 	 * Step 8: A pause of at least tINIT5 must be observed before issuing
 	 * any commands.
 	 */
-	udelay(1);
+	ddram_delay(ddram_delays.tinit5);
 
 	/*
 	 * Step 9: A Calibration command is issued to the low-power DDR2-SDRAM.
@@ -378,6 +583,7 @@ int lpddr2_sdram_initialize(unsigned int base_address,
 		     AT91C_DDRC2_MRS(10) | AT91C_DDRC2_MODE_LPDDR2_CMD);
 	asm volatile ("dmb");
 	*((unsigned volatile int *)ram_address) = 0;
+	ddram_delay(ddram_delays.tzqinit);
 
 	/*
 	 * Step 9bis: The ZQ Calibration command is now issued.
@@ -503,6 +709,8 @@ int lpddr2_sdram_initialize(unsigned int base_address,
 	write_ddramc(base_address,
 		     MPDDRC_LPDDR2_CAL_MR4, ddramc_config->cal_mr4r);
 
+	ddram_init_done(ram_address, ddramc_config);
+
 	return 0;
 }
 
@@ -514,6 +722,8 @@ int lpddr2_sdram_initialize(unsigned int base_address,
 {
 	unsigned int reg;
 
+	ddram_init_begin();
+
 	write_ddramc(base_address,
 		     MPDDRC_LPDDR2_LPR, ddramc_config->lpddr2_lpr);
 
@@ -561,7 +771,7 @@ int lpddr2_sdram_initialize(unsigned int base_address,
 	 * Step 4: A pause of at least 100 ns must be observed before
 	 * a single toggle.
 	 */
-	udelay(1);
+	ddram_delay(ddram_delays.tinit1);
 
 	/*
 	 * Step 5: A NOP command is issued to the low-power DDR2-SDRAM.
@@ -574,7 +784,7 @@ int lpddr2_sdram_initialize(unsigned int base_address,
 	 * Step 6: A pause of at least 200 us must be observed before a Reset
 	 * Command.
 	 */
-	udelay(200);
+	ddram_delay(ddram_delays.tinit);
 
 	/*
 	 * Step 7: A Reset command is issued to the low-power DDR2-SDRAM.
@@ -588,7 +798,7 @@ int lpddr2_sdram_initialize(unsigned int base_address,
 	 * Step 8: A pause of at least tINIT5 must be observed before issuing
 	 * any commands.
 	 */
-	udelay(1);
+	ddram_delay(ddram_delays.tinit5);
 
 	/*
 	 * Step 9: A Calibration command is issued to the low-power DDR2-SDRAM.
@@ -602,6 +812,7 @@ int lpddr2_sdram_initialize(unsigned int base_address,
 		     AT91C_DDRC2_MRS(10) | AT91C_DDRC2_MODE_LPDDR2_CMD);
 	asm volatile ("dmb");
 	*((unsigned volatile int *)ram_address) = 0;
+	ddram_delay(ddram_delays.tzqinit);
 
 	/*
 	 * Step 9bis: The ZQ Calibration command is now issued.
@@ -672,12 +883,21 @@ int lpddr2_sdram_initialize(unsigned int base_address,
 	write_ddramc(base_address,
 		     MPDDRC_LPDDR2_CAL_MR4, ddramc_config->cal_mr4r);
 
+	ddram_init_done(ram_address, ddramc_config);
+
 	return 0;
 }
 
 #endif
 
 #elif defined(CONFIG_DDR3)
+static const struct ddram_init_delays ddram_delays = {
+	.tinit		= 500000,
+	.txpr		= 360,			/* tRFC + 10 ns, 8 Gb */
+	.tmrd		= DDRAM_MAX(DDRAM_NCK(12), 15),	/* tMOD */
+	.tzqinit	= DDRAM_NCK(512),	/* and tDLLK */
+};
+
 
 int ddr3_sdram_initialize(unsigned int base_address,
 			unsigned int ram_address,
@@ -685,6 +905,8 @@ int ddr3_sdram_initialize(unsigned int base_address,
 {
 	unsigned int ba_offset;
 
+	ddram_init_begin();
+
 	/* Compute BA[] offset according to CR configuration */
 	ba_offset = (ddramc_config->cr & AT91C_DDRC2_NC) + 9;
 	if (!(ddramc_config->cr & AT91C_DDRC2_DECOD_INTERLEAVED))
@@ -728,7 +950,7 @@ int ddr3_sdram_initialize(unsigned int base_address,
 		/*
 		 * Step 4: A pause of at least 500us must be observed before a single toggle.
 		 */
-		udelay(500);
+		ddram_delay(ddram_delays.tinit);
 
 		/*
 		 * Step 5: A NOP command is issued to the DDR3-SDRAM
@@ -739,6 +961,7 @@ int ddr3_sdram_initialize(unsigned int base_address,
 		 */
 		write_ddramc(base_address, HDDRSDRC2_MR, AT91C_DDRC2_MODE_NOP_CMD);
 		*((unsigned volatile int *)ram_address) = 0;
+		ddram_delay(ddram_delays.txpr);
 
 		/*
 		 * Step 6: An Extended Mode Register Set (EMRS2) cycle is issued to choose
@@ -791,7 +1014,7 @@ int ddr3_sdram_initialize(unsigned int base_address,
 		write_ddramc(base_address, HDDRSDRC2_MR, AT91C_DDRC2_MODE_LMR_CMD);
 		*((unsigned int *)ram_address) = 0;
 
-		udelay(50);
+		ddram_delay(ddram_delays.tmrd);
 
 		/*
 		 * Step 11: A Calibration command (MRS) is issued to calibrate RTT and
@@ -802,6 +1025,7 @@ int ddr3_sdram_initialize(unsigned int base_address,
 		 */
 		write_ddramc(base_address, HDDRSDRC2_MR, AT91C_DDRC2_MODE_DEEP_CMD);
 		*((unsigned int *)ram_address) = 0;
+		ddram_delay(ddram_delays.tzqinit);
 
 		/*
 		 * Step 12: A Normal Mode command is provided.
@@ -836,16 +1060,27 @@ int ddr3_sdram_initialize(unsigned int base_address,
 	write_ddramc(base_address,
 		     MPDDRC_LPDDR2_CAL_MR4, ddramc_config->cal_mr4r);
 
+	ddram_init_done(ram_address, ddramc_config);
+
 	return 0;
 }
 
 #elif defined(CONFIG_LPDDR3)
+static const struct ddram_init_delays ddram_delays = {
+	.tinit		= 200000,		/* tINIT3 */
+	.tinit1		= 100,
+	.tinit5		= 10000,
+	.tzqinit	= 1000,
+};
+
 int lpddr3_sdram_initialize(unsigned int base_address,
 			    unsigned int ram_address,
 			    struct ddramc_register *ddramc_config)
 {
 	unsigned int reg;
 
+	ddram_init_begin();
+
 	write_ddramc(base_address, MPDDRC_LPDDR2_LPR,
 		     ddramc_config->lpddr2_lpr);
 
@@ -876,7 +1111,7 @@ int lpddr3_sdram_initialize(unsigned int base_address,
 	 * Step 4: A pause of at least 100ns must be observed before
 	 * a single toggle.
 	 */
-	 udelay(1);
+	ddram_delay(ddram_delays.tinit1);
 
 	/*
 	 * Step 5: A NOP command is issued to the low-power DDR3-SDRAM.
@@ -888,7 +1123,7 @@ int lpddr3_sdram_initialize(unsigned int base_address,
 	 * Step 6: A pause of at least 200us must be observed before issuing
 	 * a Reset Command
 	 */
-	udelay(200);
+	ddram_delay(ddram_delays.tinit);
 
 	/*
 	 * Step 7: A Reset command is issued to the Low-power DDR3-SDRAM.
@@ -901,7 +1136,7 @@ int lpddr3_sdram_initialize(unsigned int base_address,
 	 * Step 8: A pause of at least tINIT5 must be observed before issuing
 	 * any commands.
 	 */
-	udelay(1);
+	ddram_delay(ddram_delays.tinit5);
 
 	/*
 	 * Step 9: A Calibration command is issued to the low-power DDR3-SDRAM.
@@ -914,6 +1149,7 @@ int lpddr3_sdram_initialize(unsigned int base_address,
 	write_ddramc(base_address, HDDRSDRC2_MR,
 		     AT91C_DDRC2_MRS(10) | AT91C_DDRC2_MODE_LPDDR2_CMD);
 	*((unsigned volatile int *)ram_address) = 0;
+	ddram_delay(ddram_delays.tzqinit);
 
 	reg = read_ddramc(base_address, HDDRSDRC2_CR);
 	reg &= ~AT91C_DDRC2_ZQ;
@@ -1019,10 +1255,16 @@ int lpddr3_sdram_initialize(unsigned int base_address,
 	 */
 	write_ddramc(base_address, HDDRSDRC2_RTR, ddramc_config->rtr);
 
+	ddram_init_done(ram_address, ddramc_config);
+
 	return 0;
 }
 
 #elif defined(CONFIG_LPDDR1)
+static const struct ddram_init_delays ddram_delays = {
+	.tinit		= 200000,
+};
+
 
 int lpddr1_sdram_initialize(unsigned int base_address,
 			    unsigned int ram_address,
@@ -1030,6 +1272,8 @@ int lpddr1_sdram_initialize(unsigned int base_address,
 {
 	unsigned int ba_offset;
 
+	ddram_init_begin();
+
 	/* Compute BA[] offset according to CR configuration */
 	ba_offset = (ddramc_config->cr & AT91C_DDRC2_NC) + 8;
 	if (!(ddramc_config->cr & AT91C_DDRC2_DECOD_INTERLEAVED))
@@ -1075,7 +1319,7 @@ int lpddr1_sdram_initialize(unsigned int base_address,
 	 * Step 5: A pause of at least 200 us must be observed before
 	 * a signal toggle.
 	 */
-	 udelay(200);
+	ddram_delay(ddram_delays.tinit);
 
 	/*
 	 * Step 6: A NOP command is issued to the low-power DDR1-SDRAM.
@@ -1147,6 +1391,8 @@ int lpddr1_sdram_initialize(unsigned int base_address,
 	 */
 	write_ddramc(base_address, HDDRSDRC2_RTR, ddramc_config->rtr);
 
+	ddram_init_done(ram_address, ddramc_config);
+
 	return 0;
 }
 
@@ -0,0 +1,271 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2017, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hardware.h"
+#include "board.h"
+#include "arch/at91_ddrsdrc.h"
+#include "ddramc.h"
+#include "ddramc_timings.h"
+#include "div.h"
+#include "debug.h"
+
+/*
+ * The timings below are the minimums of the datasheets, in ps and in
+ * clock cycles, converted to cycles of the bus clock by
+ * ddramc_timings_config(): the same part can then run at any bus speed.
+ */
+
+/* Micron DDR2-667, 1 Gb, x16 */
+const struct ddram_part ddram_mt47h64m16_3 = {
+	.name	= "MT47H64M16-3",
+	.type	= DDRAM_TYPE_DDR2,
+	.trefi_ns = 7800,
+
+	.tras	= DDRAM_T(40000, 0),
+	.trcd	= DDRAM_T(15000, 0),
+	.twr	= DDRAM_T(15000, 0),
+	.trc	= DDRAM_T(55000, 0),
+	.trp	= DDRAM_T(15000, 0),
+	.trrd	= DDRAM_T(10000, 0),
+	.twtr	= DDRAM_T(7500, 2),
+	.tmrd	= DDRAM_T(0, 2),
+
+	.trfc	= DDRAM_T(127500, 0),
+	.txsnr	= DDRAM_T(137500, 0),
+	.txsrd	= DDRAM_T(0, 200),
+	.txp	= DDRAM_T(0, 2),
+
+	.txard	= DDRAM_T(0, 2),
+	.txards	= DDRAM_T(0, 7),
+	.trtp	= DDRAM_T(7500, 2),
+	.tfaw	= DDRAM_T(50000, 0),
+};
+
+/* Micron DDR2-667, 2 Gb, x16 */
+const struct ddram_part ddram_mt47h128m16_3 = {
+	.name	= "MT47H128M16-3",
+	.type	= DDRAM_TYPE_DDR2,
+	.trefi_ns = 7800,
+
+	.tras	= DDRAM_T(40000, 0),
+	.trcd	= DDRAM_T(15000, 0),
+	.twr	= DDRAM_T(15000, 0),
+	.trc	= DDRAM_T(55000, 0),
+	.trp	= DDRAM_T(15000, 0),
+	.trrd	= DDRAM_T(10000, 0),
+	.twtr	= DDRAM_T(7500, 2),
+	.tmrd	= DDRAM_T(0, 2),
+
+	.trfc	= DDRAM_T(197500, 0),
+	.txsnr	= DDRAM_T(207500, 0),
+	.txsrd	= DDRAM_T(0, 200),
+	.txp	= DDRAM_T(0, 2),
+
+	.txard	= DDRAM_T(0, 2),
+	.txards	= DDRAM_T(0, 7),
+	.trtp	= DDRAM_T(7500, 2),
+	.tfaw	= DDRAM_T(50000, 0),
+};
+
+/* Micron DDR3L-1600, 2 Gb, x16 */
+const struct ddram_part ddram_mt41k128m16_125 = {
+	.name	= "MT41K128M16-125",
+	.type	= DDRAM_TYPE_DDR3,
+	.trefi_ns = 7800,		/* not 64 ms / 8192 = 7812.5 ns */
+
+	.tras	= DDRAM_T(35000, 0),
+	.trcd	= DDRAM_T(13750, 0),
+	.twr	= DDRAM_T(15000, 4),
+	.trc	= DDRAM_T(48750, 0),
+	.trp	= DDRAM_T(13750, 0),
+	.trrd	= DDRAM_T(10000, 4),
+	.twtr	= DDRAM_T(7500, 4),
+	.tmrd	= DDRAM_T(0, 4),
+
+	.trfc	= DDRAM_T(160000, 0),
+	.txsnr	= DDRAM_T(170000, 5),
+	.txp	= DDRAM_T(6000, 3),
+
+	.trtp	= DDRAM_T(7500, 4),
+	.tfaw	= DDRAM_T(40000, 0),
+
+	.zqcs	= DDRAM_T(0, 64),
+};
+
+/* Micron LPDDR-400, 2 Gb, x16 */
+const struct ddram_part ddram_mt46h128m16lf_5 = {
+	.name	= "MT46H128M16LF-5",
+	.type	= DDRAM_TYPE_LPDDR1,
+	.trefi_ns = 7800,		/* not 64 ms / 8192 = 7812.5 ns */
+
+	.tras	= DDRAM_T(40000, 0),
+	.trcd	= DDRAM_T(15000, 0),
+	.twr	= DDRAM_T(15000, 0),
+	.trc	= DDRAM_T(55000, 0),
+	.trp	= DDRAM_T(15000, 0),
+	.trrd	= DDRAM_T(10000, 0),
+	.twtr	= DDRAM_T(0, 2),
+	.tmrd	= DDRAM_T(0, 2),
+
+	.trfc	= DDRAM_T(72000, 0),
+	.txsnr	= DDRAM_T(112500, 0),
+	.txp	= DDRAM_T(0, 2),
+};
+
+/* Micron LPDDR2-800, 4 Gb, x32 */
+const struct ddram_part ddram_mt42l128m32d1_25 = {
+	.name	= "MT42L128M32D1-25",
+	.type	= DDRAM_TYPE_LPDDR2,
+	.trefi_ns = 3900,
+
+	.tras	= DDRAM_T(42000, 3),
+	.trcd	= DDRAM_T(18000, 3),
+	.twr	= DDRAM_T(15000, 3),
+	.trc	= DDRAM_T(63000, 0),
+	.trp	= DDRAM_T(21000, 3),		/* all banks */
+	.trrd	= DDRAM_T(10000, 2),
+	.twtr	= DDRAM_T(7500, 2),
+	.tmrd	= DDRAM_T(0, 5),		/* tMRW */
+
+	.trfc	= DDRAM_T(130000, 0),		/* all banks */
+	.txsnr	= DDRAM_T(140000, 2),
+	.txp	= DDRAM_T(7500, 2),
+
+	.trtp	= DDRAM_T(7500, 2),
+	.tfaw	= DDRAM_T(50000, 8),
+
+	.zqcs	= DDRAM_T(90000, 6),
+};
+
+/* JEDEC LPDDR3-1600, 8 Gb, x32 */
+const struct ddram_part ddram_lpddr3_8gb_1600 = {
+	.name	= "LPDDR3-1600 8Gb",
+	.type	= DDRAM_TYPE_LPDDR3,
+	.trefi_ns = 3900,
+
+	.tras	= DDRAM_T(42000, 3),
+	.trcd	= DDRAM_T(18000, 3),
+	.twr	= DDRAM_T(15000, 4),
+	.trc	= DDRAM_T(63000, 0),
+	.trp	= DDRAM_T(21000, 3),		/* all banks */
+	.trrd	= DDRAM_T(10000, 2),
+	.twtr	= DDRAM_T(7500, 4),
+	.tmrd	= DDRAM_T(14000, 10),
+
+	.trfc	= DDRAM_T(210000, 0),		/* all banks */
+	.txsnr	= DDRAM_T(220000, 2),
+	.txp	= DDRAM_T(7500, 3),
+
+	.trtp	= DDRAM_T(7500, 4),
+	.tfaw	= DDRAM_T(50000, 8),
+
+	.zqcs	= DDRAM_T(90000, 6),
+};
+
+/* The bus clock period, rounded down so that the cycle counts round up */
+#define DDRAM_TCK_PS	((unsigned int)(1000000000000ULL / MASTER_CLOCK))
+
+static unsigned int ddram_cycles(const struct ddram_timing *timing,
+				 unsigned int max, unsigned int *overflow)
+{
+	unsigned int cycles = 0;
+
+	if (timing->ps)
+		cycles = div(timing->ps + DDRAM_TCK_PS - 1, DDRAM_TCK_PS);
+	if (cycles < timing->nck)
+		cycles = timing->nck;
+
+	if (cycles > max) {
+		*overflow = 1;
+		return max;
+	}
+
+	return cycles;
+}
+
+/*
+ * Compute the refresh and timing registers for @part at the bus speed,
+ * the other fields of @ddramc_config are left to the board. Returns -1
+ * when a timing does not fit in its field: it is then set to the
+ * largest value, which is too short for the part.
+ */
+#define CYCLES(timing, max)	ddram_cycles(&part->timing, max, &overflow)
+
+int ddramc_timings_config(const struct ddram_part *part,
+			  struct ddramc_register *ddramc_config)
+{
+	unsigned int overflow = 0;
+	unsigned int trp, trpa = 0;
+
+	ddramc_config->rtr = div(part->trefi_ns * (MASTER_CLOCK / 1000000),
+				 1000);
+	if (ddramc_config->rtr > 0xfff) {
+		ddramc_config->rtr = 0xfff;
+		overflow = 1;
+	}
+
+	trp = CYCLES(trp, 0xf);
+
+	ddramc_config->t0pr = (AT91C_DDRC2_TRAS_(CYCLES(tras, 0xf))
+			| AT91C_DDRC2_TRCD_(CYCLES(trcd, 0xf))
+			| AT91C_DDRC2_TWR_(CYCLES(twr, 0xf))
+			| AT91C_DDRC2_TRC_(CYCLES(trc, 0xf))
+			| AT91C_DDRC2_TRP_(trp)
+			| AT91C_DDRC2_TRRD_(CYCLES(trrd, 0xf))
+			| AT91C_DDRC2_TWTR_(CYCLES(twtr, 0xf))
+			| AT91C_DDRC2_TMRD_(CYCLES(tmrd, 0xf)));
+
+	ddramc_config->t1pr = (AT91C_DDRC2_TRFC_(CYCLES(trfc, 0x7f))
+			| AT91C_DDRC2_TXSNR_(CYCLES(txsnr, 0xff))
+			| AT91C_DDRC2_TXSRD_(CYCLES(txsrd, 0xff))
+			| AT91C_DDRC2_TXP_(CYCLES(txp, 0xf)));
+
+	/* DDR2: the precharge all of the 8 bank devices lasts tRP + 1 tCK */
+	if (part->type == DDRAM_TYPE_DDR2) {
+		trpa = trp + 1;
+		if (trpa > 0xf) {
+			trpa = 0xf;
+			overflow = 1;
+		}
+	}
+
+	ddramc_config->t2pr = (AT91C_DDRC2_TXARD_(CYCLES(txard, 0xf))
+			| AT91C_DDRC2_TXARDS_(CYCLES(txards, 0xf))
+			| AT91C_DDRC2_TRPA_(trpa)
+			| AT91C_DDRC2_TRTP_(CYCLES(trtp, 0xf))
+			| AT91C_DDRC2_TFAW_(CYCLES(tfaw, 0xf)));
+
+	ddramc_config->tim_calr = AT91C_DDRC2_ZQCS(CYCLES(zqcs, 0xff));
+
+	if (overflow) {
+		dbg_info("DDR: %s timings do not fit at %d MHz\n",
+			 part->name, MASTER_CLOCK / 1000000);
+		return -1;
+	}
+
+	return 0;
+}
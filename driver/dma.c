@@ -0,0 +1,180 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2017, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "common.h"
+#include "string.h"
+#include "dma.h"
+#include "mmu.h"
+#include "debug.h"
+#include "usart.h"
+#include "timer.h"
+
+#define DMA_MEMCPY_CHUNK	0x100000
+
+/*
+ * A transfer is given up after DMA_TIMEOUT_MS, plus the time to move
+ * its bytes at 64 KB/s, the rate of a 512 kHz SPI clock.
+ */
+#define DMA_TIMEOUT_MS		100
+#define DMA_TIMEOUT_RATE_SHIFT	6	/* bytes per ms, as log2 */
+
+/* Destination of the running transfers, invalidated once they are done */
+static struct {
+	unsigned int		count;
+	unsigned int		dst[DMA_LIST_MAX];
+	unsigned int		len[DMA_LIST_MAX];
+	unsigned long long	deadline;
+} dma_chan[DMA_CHANNELS];
+
+static unsigned int dma_fit_width(unsigned int width,
+				  const struct dma_xfer *list,
+				  unsigned int count)
+{
+	unsigned int bits = 0;
+	unsigned int i;
+
+	for (i = 0; i < count; i++)
+		bits |= list[i].src | list[i].dst | list[i].len;
+
+	while (width && (bits & ((1 << width) - 1)))
+		width--;
+
+	return width;
+}
+
+int dma_start(unsigned int chan,
+	      unsigned int perid,
+	      unsigned int width,
+	      const struct dma_xfer *list,
+	      unsigned int count)
+{
+	unsigned int total = 0;
+	unsigned int i;
+
+	if ((chan >= DMA_CHANNELS) || !count || (count > DMA_LIST_MAX))
+		return -1;
+
+	if (perid == DMA_PERID_NONE)
+		width = dma_fit_width(width, list, count);
+	else if (list[0].len & ((1 << width) - 1))
+		return -1;
+
+	dma_chan[chan].count = 0;
+	for (i = 0; i < count; i++) {
+		total += list[i].len;
+
+		if (perid & DMA_PERID_MEM2PER) {
+			/* The destination is the FIFO, nothing to invalidate */
+			dcache_clean_range(list[i].src, list[i].src
+				+ ((perid & DMA_PERID_SRC_FIXED) ?
+				   (1 << width) : list[i].len));
+			continue;
+		}
+
+		if (perid == DMA_PERID_NONE)
+			dcache_clean_range(list[i].src,
+					   list[i].src + list[i].len);
+
+		/* No dirty line may be evicted over the incoming data */
+		dcache_invalidate_range(list[i].dst,
+					list[i].dst + list[i].len);
+
+		dma_chan[chan].dst[i] = list[i].dst;
+		dma_chan[chan].len[i] = list[i].len;
+		dma_chan[chan].count = i + 1;
+	}
+
+	dma_chan[chan].deadline = timer_deadline_msec(DMA_TIMEOUT_MS
+				+ (total >> DMA_TIMEOUT_RATE_SHIFT));
+
+	return dma_hw_start(chan, perid, width, list, count);
+}
+
+int dma_wait(unsigned int chan)
+{
+	unsigned int i;
+	int ret;
+
+	do {
+		usart_poll();
+		ret = dma_poll(chan);
+	} while (!ret && !timer_expired(dma_chan[chan].deadline));
+
+	/* It may have completed while the timer was read */
+	if (!ret)
+		ret = dma_poll(chan);
+
+	if (!ret) {
+		dbg_info("DMA: channel %d: timeout\n", chan);
+		dma_stop(chan);
+		return -1;
+	}
+
+	if (ret < 0) {
+		dbg_info("DMA: channel %d: transfer error\n", chan);
+		dma_stop(chan);
+		return -1;
+	}
+
+	/* Drop the lines speculatively fetched during the transfer */
+	for (i = 0; i < dma_chan[chan].count; i++)
+		dcache_invalidate_range(dma_chan[chan].dst[i],
+			dma_chan[chan].dst[i] + dma_chan[chan].len[i]);
+
+	dma_chan[chan].count = 0;
+
+	return 0;
+}
+
+int dma_memcpy(void *dst, const void *src, unsigned int len)
+{
+	unsigned char *to = dst;
+	const unsigned char *from = src;
+	unsigned int size;
+
+	/* Byte wide DMA is slower than the CPU copy */
+	if (((unsigned int)to | (unsigned int)from | len) & 0x3) {
+		memcpy(dst, src, len);
+		return 0;
+	}
+
+	while (len) {
+		size = (len > DMA_MEMCPY_CHUNK) ? DMA_MEMCPY_CHUNK : len;
+
+		if (dma_memcpy_start(0, to, from, size))
+			return -1;
+
+		if (dma_wait(0))
+			return -1;
+
+		to += size;
+		from += size;
+		len -= size;
+	}
+
+	return 0;
+}
@@ -5,6 +5,7 @@ DRIVERS:=
 DRIVERS_SRC:=$(TOPDIR)/driver
 
 COBJS-$(CONFIG_DEBUG)		+= $(DRIVERS_SRC)/debug.o
+COBJS-$(CONFIG_BOOTSTAGE)	+= $(DRIVERS_SRC)/bootstage.o
 
 COBJS-$(CONFIG_SCLK)		+= $(DRIVERS_SRC)/at91_slowclk.o
 
@@ -17,10 +18,22 @@ COBJS-y				+= $(DRIVERS_SRC)/at91_usart.o
 COBJS-y				+= $(DRIVERS_SRC)/at91_rstc.o
 
 COBJS-$(CPU_HAS_L2CC)		+= $(DRIVERS_SRC)/lp310_l2cc.o
+COBJS-$(CONFIG_L2CACHE_BENCH)	+= $(DRIVERS_SRC)/l2cc_bench.o
+
+COBJS-$(CONFIG_MMU)		+= $(DRIVERS_SRC)/mmu.o
+COBJS-$(CONFIG_MMU)		+= $(DRIVERS_SRC)/cp15.o
+
+ifeq ($(CONFIG_DMA),y)
+COBJS-y				+= $(DRIVERS_SRC)/dma.o
+COBJS-$(CPU_HAS_XDMAC)		+= $(DRIVERS_SRC)/at91_xdmac.o
+COBJS-$(CPU_HAS_DMAC)		+= $(DRIVERS_SRC)/at91_dmac.o
+endif
 
 COBJS-$(CONFIG_SDRAM)		+= $(DRIVERS_SRC)/sdramc.o
 COBJS-$(CONFIG_SDDRC)		+= $(DRIVERS_SRC)/sddrc.o
 COBJS-$(CONFIG_DDRC)		+= $(DRIVERS_SRC)/ddramc.o
+COBJS-$(CONFIG_DDR_TIMINGS)	+= $(DRIVERS_SRC)/ddramc_timings.o
+COBJS-$(CONFIG_DDR_MEMTEST)	+= $(DRIVERS_SRC)/ddr_memtest.o
 
 COBJS-$(CONFIG_AT91_MCI)	+= $(DRIVERS_SRC)/at91_mci.o
 COBJS-$(CONFIG_SDHC)		+= $(DRIVERS_SRC)/sdhc.o
@@ -38,7 +51,9 @@ COBJS-$(CONFIG_SPI_FLASH)	+= $(DRIVERS_SRC)/spi_flash/spi_nor.o
 COBJS-$(CONFIG_SPI_FLASH)	+= $(DRIVERS_SRC)/spi_flash/spi_nor_ids.o
 
 COBJS-$(CONFIG_SPI)		+= $(DRIVERS_SRC)/at91_spi.o
+ifneq ($(CONFIG_SPI_NOR),y)
 COBJS-$(CONFIG_SPI)		+= $(DRIVERS_SRC)/spi_flash.o
+endif
 COBJS-$(CONFIG_QSPI)		+= $(DRIVERS_SRC)/at91_qspi.o
 COBJS-$(CONFIG_DATAFLASH)	+= $(DRIVERS_SRC)/dataflash.o
 
@@ -38,6 +38,14 @@ ifeq ($(CONFIG_DDR3),y)
 CPPFLAGS += -DCONFIG_DDR3
 endif
 
+ifeq ($(CONFIG_DDR_SIZE_DETECT),y)
+CPPFLAGS += -DCONFIG_DDR_SIZE_DETECT
+endif
+
+ifeq ($(CONFIG_DDR_MEMTEST),y)
+CPPFLAGS += -DCONFIG_DDR_MEMTEST
+endif
+
 # Support for PSRAM on SAM9263EK EBI1
 
 ifeq ($(CONFIG_PSRAM),y)
@@ -103,6 +111,18 @@ ifeq ($(CONFIG_LINUX_IMAGE), y)
 CPPFLAGS += -DCONFIG_LINUX_IMAGE
 endif
 
+ifeq ($(CONFIG_KERNEL_LZ4),y)
+CPPFLAGS += -DCONFIG_KERNEL_LZ4
+endif
+
+ifeq ($(CONFIG_KERNEL_CRC),y)
+CPPFLAGS += -DCONFIG_KERNEL_CRC
+endif
+
+ifeq ($(CONFIG_CRC32_SLICE_BY_8),y)
+CPPFLAGS += -DCONFIG_CRC32_SLICE_BY_8
+endif
+
 ifeq ($(CONFIG_OF_LIBFDT),y)
 CPPFLAGS += -DCONFIG_OF_LIBFDT
 endif
@@ -132,6 +152,18 @@ ifeq ($(CONFIG_NANDFLASH_SMALL_BLOCKS),y)
 CPPFLAGS += -DCONFIG_NANDFLASH_SMALL_BLOCKS
 endif
 
+ifeq ($(CONFIG_NANDFLASH_DMA),y)
+CPPFLAGS += -DCONFIG_NANDFLASH_DMA
+endif
+
+ifeq ($(CONFIG_NANDFLASH_CACHE_READ),y)
+CPPFLAGS += -DCONFIG_NANDFLASH_CACHE_READ
+endif
+
+ifeq ($(CONFIG_NANDFLASH_BBT),y)
+CPPFLAGS += -DCONFIG_NANDFLASH_BBT
+endif
+
 ifeq ($(CONFIG_ENABLE_SW_ECC), y)
 CPPFLAGS += -DCONFIG_ENABLE_SW_ECC
 endif
@@ -341,6 +373,14 @@ ifeq ($(CONFIG_SECURE), y)
 CPPFLAGS += -DCONFIG_SECURE
 endif
 
+ifeq ($(CPU_HAS_AES_GCM), y)
+CPPFLAGS += -DCPU_HAS_AES_GCM
+endif
+
+ifeq ($(CONFIG_SECURE_STREAM), y)
+CPPFLAGS += -DCONFIG_SECURE_STREAM
+endif
+
 ifeq ($(CONFIG_BACKUP_MODE), y)
 CPPFLAGS += -DCONFIG_BACKUP_MODE
 endif
@@ -417,6 +457,22 @@ ifeq ($(CONFIG_SPI), y)
 CPPFLAGS += -DCONFIG_SPI
 endif
 
+ifeq ($(CONFIG_SPI_NOR), y)
+CPPFLAGS += -DCONFIG_SPI_NOR
+endif
+
+ifeq ($(CONFIG_SPI_FIFO), y)
+CPPFLAGS += -DCONFIG_SPI_FIFO
+endif
+
+ifeq ($(CONFIG_SPI_PDC), y)
+CPPFLAGS += -DCONFIG_SPI_PDC
+endif
+
+ifeq ($(CONFIG_SPI_DMA), y)
+CPPFLAGS += -DCONFIG_SPI_DMA
+endif
+
 ifeq ($(CONFIG_QSPI_BUS0), y)
 CPPFLAGS += -DCONFIG_QSPI_BUS0
 endif
@@ -457,6 +513,18 @@ ifeq ($(CONFIG_QSPI_XIP), y)
 CPPFLAGS += -DCONFIG_QSPI_XIP
 endif
 
+ifeq ($(CONFIG_QSPI_DMA), y)
+CPPFLAGS += -DCONFIG_QSPI_DMA
+endif
+
+ifeq ($(CONFIG_QSPI_CALIBRATION), y)
+CPPFLAGS += -DCONFIG_QSPI_CALIBRATION
+endif
+
+ifeq ($(CONFIG_QSPI_CALIBRATION_BUREG), y)
+CPPFLAGS += -DCONFIG_QSPI_CALIBRATION_BUREG
+endif
+
 ifeq ($(CONFIG_QSPI), y)
 CPPFLAGS += -DCONFIG_QSPI
 endif
@@ -31,6 +31,7 @@
 #include "string.h"
 #include "debug.h"
 #include "fdt.h"
+#include "bootstage.h"
 
 #include "debug.h"
 
@@ -58,13 +59,37 @@ static int update_image_length(unsigned int offset,
 #endif
 	return -1;
 }
+
+/*
+ * update_image_length() has copied the first 512 bytes of the image to
+ * head already: move them to dest if need be, and only copy the rest.
+ */
+static void copy_image_next(unsigned int offset,
+			    unsigned int length,
+			    unsigned char *dest,
+			    unsigned char *head)
+{
+	unsigned int size = 512;
+
+	if (size > length)
+		size = length;
+
+	if (dest != head)
+		memmove(dest, head, size);
+
+	memcpy(dest + size, (const char *)(offset + size), length - size);
+}
 #endif
 
 int load_norflash(struct image_info *image)
 {
 	int length = 0;
+#if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+	unsigned char *head = image->dest;
+#endif
 
 	norflash_hw_init();
+	bootstage_mark("media_init");
 
 #if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
 	length = update_image_length(image->offset, image->dest, KERNEL_IMAGE);
@@ -72,12 +97,18 @@ int load_norflash(struct image_info *image)
 		return -1;
 
 	image->length = length;
+	image->dest = kernel_image_dest(image);
 #endif
 
 	dbg_info("FLASH: copy %x bytes from %x to %x\n",
 		 image->length, image->offset, image->dest);
 
+#if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+	copy_image_next(image->offset, image->length, image->dest, head);
+#else
 	memcpy(image->dest, (const char *)image->offset, image->length);
+#endif
+	bootstage_mark("image");
 
 #ifdef CONFIG_OF_LIBFDT
 	length = update_image_length(image->of_offset,
@@ -90,8 +121,9 @@ int load_norflash(struct image_info *image)
 	dbg_info("FLASH: dt blob: Copy %x bytes from %x to %x\n",
 		image->of_length, image->of_offset, image->of_dest);
 
-	memcpy(image->of_dest,
-	       (const char *)image->of_offset, image->of_length);
+	copy_image_next(image->of_offset, image->of_length,
+			image->of_dest, image->of_dest);
+	bootstage_mark("dtb");
 #endif
 	return 0;
 }
@@ -0,0 +1,121 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2017, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "common.h"
+#include "hardware.h"
+#include "board.h"
+#include "string.h"
+#include "timer.h"
+#include "l2cc.h"
+#include "aes.h"
+#include "div.h"
+#include "debug.h"
+
+/*
+ * DDR to DDR copies, and an AES-CBC decryption when the AES driver is
+ * built, timed with the L2 cache on and then off. The 32 KB copy misses
+ * the L1 but fits in the L2, the 1 MB one streams through both.
+ * It runs before the image is loaded, the start of the DDR is free.
+ */
+#define L2CC_BENCH_SRC		AT91C_BASE_DDRCS
+#define L2CC_BENCH_DST		(AT91C_BASE_DDRCS + L2CC_BENCH_MAX)
+#define L2CC_BENCH_MAX		(1 << 20)
+#define L2CC_BENCH_BYTES	(4 << 20)
+
+#define L2CC_BENCH_COPY_SMALL	0
+#define L2CC_BENCH_COPY_LARGE	1
+#define L2CC_BENCH_DECRYPT	2
+#define L2CC_BENCH_RUNS		3
+
+static const char *const l2cache_bench_names[L2CC_BENCH_RUNS] = {
+	"copy 32 KB",
+	"copy 1 MB",
+	"AES-CBC decrypt 1 MB",
+};
+
+/* In bytes per us, that is MB/s */
+static unsigned int l2cache_bench_run(unsigned int run)
+{
+	void *src = (void *)L2CC_BENCH_SRC;
+	void *dst = (void *)L2CC_BENCH_DST;
+	unsigned int size = L2CC_BENCH_MAX;
+	unsigned int done, ticks, usec;
+#ifdef CONFIG_AES
+	static const unsigned int key[4], iv[4];
+#endif
+
+	if (run == L2CC_BENCH_COPY_SMALL)
+		size = 32 * 1024;
+
+	/* warm up, and the TLB entries */
+	memcpy(dst, src, size);
+
+	ticks = timer_get_ticks();
+	for (done = 0; done < L2CC_BENCH_BYTES; done += size) {
+#ifdef CONFIG_AES
+		if (run == L2CC_BENCH_DECRYPT) {
+			at91_aes_cbc(size, src, dst, 0,
+				     AT91_AES_KEY_SIZE_128, key, iv);
+			continue;
+		}
+#endif
+		memcpy(dst, src, size);
+	}
+	usec = timer_ticks_to_usec(timer_get_ticks() - ticks);
+
+	return usec ? div(L2CC_BENCH_BYTES, usec) : 0;
+}
+
+void l2cache_bench(void)
+{
+	unsigned int rate_on[L2CC_BENCH_RUNS];
+	unsigned int rate_off[L2CC_BENCH_RUNS];
+	unsigned int runs = L2CC_BENCH_DECRYPT;
+	unsigned int run;
+
+#ifdef CONFIG_AES
+	at91_aes_init();
+	runs = L2CC_BENCH_RUNS;
+#endif
+
+	/* Turned on by mmu_enable() */
+	for (run = 0; run < runs; run++)
+		rate_on[run] = l2cache_bench_run(run);
+
+	l2cache_disable();
+	for (run = 0; run < runs; run++)
+		rate_off[run] = l2cache_bench_run(run);
+	l2cache_enable();
+
+#ifdef CONFIG_AES
+	at91_aes_cleanup();
+#endif
+
+	for (run = 0; run < runs; run++)
+		dbg_info("L2: %s: %d MB/s with the L2 cache, %d MB/s without\n",
+			 l2cache_bench_names[run], rate_on[run], rate_off[run]);
+}
@@ -40,17 +40,43 @@
 #include "mon.h"
 #include "tz_utils.h"
 #include "secure.h"
+#include "mmu.h"
+#include "ddramc.h"
+#include "lz4.h"
+#include "crc32.h"
+#include "bootstage.h"
+#include "usart.h"
 
 #include "debug.h"
 
 static char *bootargs;
 
+static unsigned int kernel_mem_size(void)
+{
+#ifdef CONFIG_DDR_SIZE_DETECT
+	return ddram_get_size();
+#else
+	return MEM_SIZE;
+#endif
+}
+
+/* End of the RAM the images may be loaded or decompressed to */
+static unsigned int kernel_load_end(void)
+{
+#ifdef CONFIG_MMU
+	/* The translation table is live until the jump */
+	return mmu_table_addr();
+#else
+	return MEM_BANK + kernel_mem_size();
+#endif
+}
+
 #ifdef CONFIG_OF_LIBFDT
 
 static int setup_dt_blob(void *blob)
 {
 	unsigned int mem_bank = MEM_BANK;
-	unsigned int mem_size = MEM_SIZE;
+	unsigned int mem_size = kernel_mem_size();
 	int ret;
 
 	if (check_dt_blob_valid(blob)) {
@@ -80,6 +106,11 @@ static int setup_dt_blob(void *blob)
 	if (ret)
 		return ret;
 
+	bootstage_mark("dt_fixup");
+	ret = bootstage_fixup_fdt(blob);
+	if (ret)
+		return ret;
+
 	return 0;
 }
 #else
@@ -173,7 +204,7 @@ static void setup_boot_params(void)
 	memparam->header.size = TAG_SIZE_MEM32;
 
 	memparam->start = MEM_BANK;
-	memparam->size = MEM_SIZE;
+	memparam->size = kernel_mem_size();
 
 	params = (unsigned int *)params + TAG_SIZE_MEM32;
 
@@ -215,6 +246,11 @@ int kernel_size(unsigned char *add)
 	return 0;
 }
 
+unsigned char *kernel_image_dest(struct image_info *image)
+{
+	return image->dest;
+}
+
 static int boot_image_setup(unsigned char *addr, unsigned int *entry)
 {
 	*entry = (unsigned int)addr;
@@ -239,6 +275,9 @@ struct linux_uimage_header {
 	unsigned char	name[32];
 };
 
+#define IH_COMP_NONE		0
+#define IH_COMP_LZ4		5
+
 /* Linux zImage Header */
 #define	LINUX_ZIMAGE_MAGIC	0x016f2818
 struct linux_zimage_header {
@@ -271,6 +310,262 @@ int kernel_size(unsigned char *addr)
 	return (int)size;
 }
 
+#if defined(CONFIG_KERNEL_LZ4) || defined(CONFIG_KERNEL_CRC)
+/*
+ * The loaders report each chunk of the image as it lands: the data CRC
+ * is computed and the LZ4 blocks are decompressed to the load address
+ * right away, so that this overlaps the reads. What is left, or the
+ * whole image when the loader does not report its chunks, is done by
+ * boot_image_setup().
+ */
+#define KERNEL_STREAM_IDLE	0
+#define KERNEL_STREAM_HEADER	1
+#define KERNEL_STREAM_DATA	2
+
+struct kernel_stream {
+	unsigned int		state;
+	unsigned char		*base;		/* uImage header */
+	unsigned char		*loaded;	/* end of the data reported so far */
+	unsigned char		*end;		/* end of the uImage */
+#ifdef CONFIG_KERNEL_CRC
+	unsigned char		*crc_pos;	/* end of the data in crc */
+	unsigned int		crc;
+#endif
+#ifdef CONFIG_KERNEL_LZ4
+	unsigned int		is_lz4;
+	struct lz4_stream	lz4;
+	unsigned char		*of_dest;	/* dt blob, out of the output */
+#endif
+};
+
+static struct kernel_stream kernel_stream;
+
+#ifdef CONFIG_KERNEL_LZ4
+/* Set up the decompression of an LZ4 uImage to its load address */
+static int kernel_lz4_init(struct kernel_stream *s, unsigned char *addr)
+{
+	struct linux_uimage_header *uimage_header
+			= (struct linux_uimage_header *)addr;
+	unsigned char *src = addr + sizeof(*uimage_header);
+	unsigned char *src_end = src + swap_uint32(uimage_header->size);
+	unsigned char *dest = (unsigned char *)swap_uint32(uimage_header->load);
+	unsigned char *dest_end = (unsigned char *)kernel_load_end();
+
+	/* The output must not run over the compressed data */
+	if (dest < addr) {
+		if (dest_end > addr)
+			dest_end = addr;
+	} else if (dest < src_end) {
+		dbg_info("LZ4: The load address overlaps the image\n");
+		return -1;
+	}
+
+	/* Nor over the dt blob, whether loaded already or not */
+	if ((s->of_dest > dest) && (dest_end > s->of_dest))
+		dest_end = s->of_dest;
+
+	if (dest >= dest_end) {
+		dbg_info("LZ4: Bad load address: %x\n", (unsigned int)dest);
+		return -1;
+	}
+
+	lz4_stream_init(&s->lz4, src, dest, dest_end - dest);
+
+	return 0;
+}
+#endif
+
+/* Start processing the uImage at addr */
+static int kernel_stream_begin(struct kernel_stream *s, unsigned char *addr)
+{
+	struct linux_uimage_header *uimage_header
+			= (struct linux_uimage_header *)addr;
+
+	s->base = addr;
+	s->end = addr + sizeof(*uimage_header)
+		 + swap_uint32(uimage_header->size);
+#ifdef CONFIG_KERNEL_CRC
+	s->crc_pos = addr + sizeof(*uimage_header);
+	s->crc = 0;
+#endif
+#ifdef CONFIG_KERNEL_LZ4
+	s->is_lz4 = (uimage_header->comp_type == IH_COMP_LZ4);
+	if (s->is_lz4 && kernel_lz4_init(s, addr))
+		return -1;
+#endif
+	s->state = KERNEL_STREAM_DATA;
+
+	return 0;
+}
+
+static void kernel_stream_process(struct kernel_stream *s, unsigned char *end)
+{
+	if (end > s->end)
+		end = s->end;
+
+#ifdef CONFIG_KERNEL_CRC
+	if (end > s->crc_pos) {
+		s->crc = crc32(s->crc, s->crc_pos, end - s->crc_pos);
+		s->crc_pos = end;
+	}
+#endif
+#ifdef CONFIG_KERNEL_LZ4
+	if (s->is_lz4)
+		lz4_stream_decode(&s->lz4, end);
+#endif
+}
+
+/* The loader is about to put the image at dest rather than at addr */
+static void kernel_stream_move(unsigned char *addr, unsigned char *dest)
+{
+	struct kernel_stream *s = &kernel_stream;
+
+	if ((s->base != addr) || (s->state == KERNEL_STREAM_IDLE))
+		return;
+
+	s->base = dest;
+	s->loaded = dest + (s->loaded - addr);
+	if (s->state == KERNEL_STREAM_DATA) {
+		s->end = dest + (s->end - addr);
+#ifdef CONFIG_KERNEL_CRC
+		s->crc_pos = dest + (s->crc_pos - addr);
+#endif
+	}
+}
+
+void kernel_stream_start(void *data)
+{
+	kernel_stream.state = KERNEL_STREAM_HEADER;
+	kernel_stream.base = (unsigned char *)data;
+	kernel_stream.loaded = kernel_stream.base;
+}
+
+void kernel_stream_update(const void *data, unsigned int length)
+{
+	struct kernel_stream *s = &kernel_stream;
+	struct linux_uimage_header *uimage_header
+			= (struct linux_uimage_header *)s->base;
+
+	if (!s->base)
+		return;
+
+	/* The image is read again from its start, e.g. after its length */
+	if (data == s->base) {
+		s->state = KERNEL_STREAM_HEADER;
+		s->loaded = s->base;
+	}
+
+	if ((s->state == KERNEL_STREAM_IDLE) || (data != s->loaded))
+		return;
+
+	s->loaded += length;
+
+	if (s->state == KERNEL_STREAM_HEADER) {
+		if (s->loaded < s->base + sizeof(*uimage_header))
+			return;
+
+		if ((swap_uint32(uimage_header->magic) != LINUX_UIMAGE_MAGIC)
+		    || kernel_stream_begin(s, s->base)) {
+			s->state = KERNEL_STREAM_IDLE;
+			return;
+		}
+	}
+
+	kernel_stream_process(s, s->loaded);
+}
+
+/* Process the uImage at addr up to its end, -1 on error */
+static int kernel_stream_finish(unsigned char *addr)
+{
+	struct kernel_stream *s = &kernel_stream;
+
+	/* Carry on from where the stream is, if it followed this image */
+	if ((s->state != KERNEL_STREAM_DATA) || (s->base != addr)) {
+		if (kernel_stream_begin(s, addr))
+			return -1;
+	}
+
+	kernel_stream_process(s, s->end);
+	s->state = KERNEL_STREAM_IDLE;
+	s->base = 0;
+
+	return 0;
+}
+#endif /* #if defined(CONFIG_KERNEL_LZ4) || defined(CONFIG_KERNEL_CRC) */
+
+#ifdef CONFIG_KERNEL_CRC
+static int kernel_crc_check(unsigned char *addr)
+{
+	struct linux_uimage_header *uimage_header
+			= (struct linux_uimage_header *)addr;
+	struct linux_uimage_header header;
+
+	/* The header CRC is computed with its own field cleared */
+	memcpy(&header, uimage_header, sizeof(header));
+	header.header_crc = 0;
+	if (crc32(0, &header, sizeof(header))
+	    != swap_uint32(uimage_header->header_crc)) {
+		dbg_info("uImage: Bad header CRC\n");
+		return -1;
+	}
+
+	if (kernel_stream.crc != swap_uint32(uimage_header->data_crc)) {
+		dbg_info("uImage: Bad data CRC\n");
+		return -1;
+	}
+
+	return 0;
+}
+#endif
+
+/*
+ * The header of the kernel image has been read to image->dest: returns
+ * where the loader should put the whole image instead. An uncompressed
+ * uImage goes right below its load address, so that its payload lands
+ * in place and boot_image_setup() has nothing to relocate.
+ */
+unsigned char *kernel_image_dest(struct image_info *image)
+{
+	struct linux_uimage_header *uimage_header
+			= (struct linux_uimage_header *)image->dest;
+	unsigned int dest, end;
+#ifdef CONFIG_OF_LIBFDT
+	unsigned int of_end;
+#endif
+
+	if ((swap_uint32(uimage_header->magic) != LINUX_UIMAGE_MAGIC)
+	    || (uimage_header->comp_type != IH_COMP_NONE))
+		return image->dest;
+
+	dest = swap_uint32(uimage_header->load)
+		- sizeof(struct linux_uimage_header);
+	end = swap_uint32(uimage_header->load)
+		+ swap_uint32(uimage_header->size);
+
+	if ((dest < MEM_BANK) || (end > kernel_load_end())
+	    || (end < dest))
+		return image->dest;
+
+#ifdef CONFIG_OF_LIBFDT
+	/* Keep clear of the dt blob, whether loaded already or not */
+	of_end = (unsigned int)image->of_dest;
+#if defined(CONFIG_DATAFLASH) || defined(CONFIG_NANDFLASH) || defined(CONFIG_FLASH)
+	of_end += image->of_length;
+#endif
+	if (((unsigned int)image->of_dest < end) && (dest <= of_end))
+		return image->dest;
+#endif
+
+	if (dest != (unsigned int)image->dest) {
+		dbg_info("Loading uImage in place at %x\n", dest);
+#if defined(CONFIG_KERNEL_LZ4) || defined(CONFIG_KERNEL_CRC)
+		kernel_stream_move(image->dest, (unsigned char *)dest);
+#endif
+	}
+
+	return (unsigned char *)dest;
+}
+
 static int boot_image_setup(unsigned char *addr, unsigned int *entry)
 {
 	struct linux_zimage_header *zimage_header
@@ -294,16 +589,48 @@ static int boot_image_setup(unsigned char *addr, unsigned int *entry)
 	if (magic == LINUX_UIMAGE_MAGIC) {
 		dbg_info("\nBooting uImage ......\n");
 
-		if (uimage_header->comp_type != 0) {
-			dbg_info("The uImage compress type not supported\n");
-			return -1;
-		}
-
 		size = swap_uint32(uimage_header->size);
 		dest = swap_uint32(uimage_header->load);
 		src = (unsigned int)addr + sizeof(struct linux_uimage_header);
 		*entry = swap_uint32(uimage_header->entry_point);
 
+#if defined(CONFIG_KERNEL_LZ4) || defined(CONFIG_KERNEL_CRC)
+		if (kernel_stream_finish(addr))
+			return -1;
+#endif
+
+#ifdef CONFIG_KERNEL_CRC
+		if (kernel_crc_check(addr))
+			return -1;
+#endif
+
+#ifdef CONFIG_KERNEL_LZ4
+		if (uimage_header->comp_type == IH_COMP_LZ4) {
+			dbg_info("Decompressing kernel image, dest: %x, src: %x\n",
+					dest, src);
+
+			if (kernel_stream.lz4.state != LZ4_STREAM_DONE) {
+				dbg_info("LZ4: Corrupted kernel image\n");
+				return -1;
+			}
+
+			size = kernel_stream.lz4.out - kernel_stream.lz4.out_start;
+
+			dbg_info(" ...... %x bytes data decompressed\n", size);
+
+			return 0;
+		}
+#endif
+
+		if (uimage_header->comp_type != IH_COMP_NONE) {
+			dbg_info("The uImage compress type not supported\n");
+			return -1;
+		}
+
+		/* Loaded in place by the loader, see kernel_image_dest() */
+		if (dest == src)
+			return 0;
+
 		dbg_info("Relocating kernel image, dest: %x, src: %x\n",
 				dest, src);
 
@@ -359,15 +686,25 @@ int load_kernel(struct image_info *image)
 
 	bootargs = board_override_cmd_line();
 
+#if defined(CONFIG_KERNEL_LZ4) && defined(CONFIG_OF_LIBFDT)
+	kernel_stream.of_dest = image->of_dest;
+#endif
+#if !defined(CONFIG_SECURE)
+	/* the stream would see the image before its decryption */
+	kernel_stream_start(image->dest);
+#endif
+
 	ret = load_kernel_image(image);
 	if (ret)
 		return ret;
+	bootstage_mark("load");
 
 #if defined(CONFIG_SECURE)
 	ret = secure_check(image->dest);
 	if (ret)
 		return ret;
 	image->dest += sizeof(at91_secure_header_t);
+	bootstage_mark("secure");
 #endif
 
 #ifdef CONFIG_SCLK
@@ -380,6 +717,7 @@ int load_kernel(struct image_info *image)
 #endif
 	if (ret)
 		return -1;
+	bootstage_mark("kernel_setup");
 
 	kernel_entry = (void (*)(int, int, unsigned int))entry_point;
 
@@ -397,8 +735,16 @@ int load_kernel(struct image_info *image)
 	r2 = (unsigned int)(MEM_BANK + 0x100);
 #endif
 
+	bootstage_mark("jump");
+	bootstage_report();
+
 	dbg_info("\nStarting linux kernel ..., machid: %x\n\n",
 							mach_type);
+
+#ifdef CONFIG_MMU
+	mmu_disable();
+#endif
+
 #if defined(CONFIG_ENTER_NWD)
 	monitor_init();
 
@@ -406,9 +752,11 @@ int load_kernel(struct image_info *image)
 
 	dbg_info("Enter Normal World, Run Kernel at %x\n",
 					(unsigned int)kernel_entry);
+	usart_flush();
 
 	enter_normal_world();
 #else
+	usart_flush();
 	kernel_entry(0, mach_type, r2);
 #endif
 
@@ -39,6 +39,18 @@ static inline unsigned int read_l2cc(unsigned int offset)
 	return readl(offset + AT91C_BASE_L2CC);
 }
 
+#define L2CC_LINE_SIZE		32
+#define L2CC_LINE_MASK		(L2CC_LINE_SIZE - 1)
+#define L2CC_ALL_WAYS		0x0000ffff
+
+/*
+ * Prefetch tuning: the offset is how many lines ahead of a miss the
+ * controller prefetches, the DDR on these parts is slow enough compared
+ * to the core for a few lines ahead to pay off on sequential copies.
+ * Allowed values are 0 to 7, 15, 23 and 31.
+ */
+#define L2CC_PREFETCH_OFFSET	7
+
 #if defined(SAMA5D2)
 static void l2cache_configure_ram(void)
 {
@@ -77,12 +89,26 @@ void l2cache_prepare(void)
 	L2CC->L2CC_DRCR = cfg;
 */
 
+	/* Write responses from the controller instead of the slave */
+	cfg = read_l2cc(L2CC_ACR);
+	cfg |= L2CC_ACR_EBRESPE;
+	write_l2cc(L2CC_ACR, cfg);
+
 	/* Prefetch Control */
 	cfg = read_l2cc(L2CC_PCR);
-	/* prefetch offset: TODO find proper values */
-	cfg |= 0x1;
+	cfg &= ~L2CC_PCR_OFFSET(0x1f);
+	cfg |= L2CC_PCR_OFFSET(L2CC_PREFETCH_OFFSET);
 	cfg |= L2CC_PCR_IDLEN | L2CC_PCR_PDEN | L2CC_PCR_DLEN;
 	cfg |= L2CC_PCR_DATPEN | L2CC_PCR_INSPEN;
+	/* Erratum 752271: no double linefill on WRAP reads before r3p2 */
+	switch (read_l2cc(L2CC_IDR) & L2CC_IDR_RTL_MASK) {
+	case L2CC_IDR_RTL_R3P0:
+	case L2CC_IDR_RTL_R3P1:
+		cfg |= L2CC_PCR_DLFWRDIS;
+		break;
+	default:
+		break;
+	}
 	write_l2cc(L2CC_PCR, cfg);
 
 	/* Power Control */
@@ -91,7 +117,7 @@ void l2cache_prepare(void)
 	write_l2cc(L2CC_POWCR, cfg);
 
 	/* invalidate all entries */
-	cfg = 0x0000ffff;
+	cfg = L2CC_ALL_WAYS;
 	write_l2cc(L2CC_IWR, cfg);
 	/* check invalidate operation finished */
 	while (read_l2cc(L2CC_IWR) != 0)
@@ -123,5 +149,64 @@ void l2cache_prepare(void)
 void l2cache_enable(void)
 {
 	/* enable cache, now! */
-	write_l2cc(L2CC_CR, 1);
+	write_l2cc(L2CC_CR, L2CC_CR_L2CEN);
+}
+
+static void l2cache_sync(void)
+{
+	write_l2cc(L2CC_CSR, 0);
+	while (read_l2cc(L2CC_CSR) & L2CC_CSR_C)
+		;
+}
+
+/*
+ * Called with the L1 data cache still on: what it writes back after
+ * this point goes straight to the memory.
+ */
+void l2cache_disable(void)
+{
+	if (!(read_l2cc(L2CC_CR) & L2CC_CR_L2CEN))
+		return;
+
+	write_l2cc(L2CC_CIWR, L2CC_ALL_WAYS);
+	while (read_l2cc(L2CC_CIWR) != 0)
+		;
+	l2cache_sync();
+
+	write_l2cc(L2CC_CR, 0);
+}
+
+/*
+ * Maintenance by physical address, called from the L1 range operations
+ * for buffers shared with a DMA master. The MMU maps one to one.
+ */
+void l2cache_clean_range(unsigned int start, unsigned int end)
+{
+	for (start &= ~L2CC_LINE_MASK; start < end; start += L2CC_LINE_SIZE)
+		write_l2cc(L2CC_CPALR, start);
+
+	l2cache_sync();
+}
+
+/*
+ * The caller has already written the partial edge lines back from L1:
+ * they are cleaned here too, the whole lines are simply dropped.
+ */
+void l2cache_invalidate_range(unsigned int start, unsigned int end)
+{
+	if (start & L2CC_LINE_MASK) {
+		start &= ~L2CC_LINE_MASK;
+		write_l2cc(L2CC_CIPALR, start);
+		start += L2CC_LINE_SIZE;
+	}
+
+	if (end & L2CC_LINE_MASK) {
+		end &= ~L2CC_LINE_MASK;
+		write_l2cc(L2CC_CIPALR, end);
+	}
+
+	for (; start < end; start += L2CC_LINE_SIZE)
+		write_l2cc(L2CC_IPALR, start);
+
+	l2cache_sync();
 }
@@ -0,0 +1,155 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2017, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hardware.h"
+#include "board.h"
+#include "mmu.h"
+#include "l2cc.h"
+#include "ddramc.h"
+#include "debug.h"
+
+/*
+ * Short-descriptor section entries. The identity map keeps the internal
+ * SRAM and the external RAM cacheable (write-back), everything else
+ * (peripherals, EBI chip selects, QSPI memory window) strongly-ordered.
+ */
+#define TTB_SECT			(0x2 << 0)
+#define TTB_SECT_B			(0x1 << 2)
+#define TTB_SECT_C			(0x1 << 3)
+#define TTB_SECT_DOMAIN(x)		(((x) & 0xf) << 5)
+#define TTB_SECT_AP_RW			(0x3 << 10)
+
+#if defined(CORE_CORTEX_A5)
+#define TTB_SECT_XN			(0x1 << 4)
+#define TTB_SECT_TEX(x)			(((x) & 0x7) << 12)
+
+/* Normal, outer and inner write-back, write-allocate */
+#define TTB_SECT_NORMAL		(TTB_SECT_TEX(1) | TTB_SECT_C | TTB_SECT_B)
+#define TTB_SECT_STRONGLY_ORDERED	(TTB_SECT_XN)
+#else
+/* Bit 4 should be one on ARMv5 */
+#define TTB_SECT_SBO			(0x1 << 4)
+
+#define TTB_SECT_NORMAL		(TTB_SECT_SBO | TTB_SECT_C | TTB_SECT_B)
+#define TTB_SECT_STRONGLY_ORDERED	(TTB_SECT_SBO)
+#endif
+
+#define TTB_SECT_ATTR	(TTB_SECT | TTB_SECT_DOMAIN(0) | TTB_SECT_AP_RW)
+
+#if defined(AT91SAM9G45)
+#define MMU_RAM_BASE	AT91C_BASE_CS6
+#elif defined(AT91SAM9263)
+#define MMU_RAM_BASE	AT91C_BASE_EBI0_CS1
+#elif defined(AT91C_BASE_DDRCS)
+#define MMU_RAM_BASE	AT91C_BASE_DDRCS
+#else
+#define MMU_RAM_BASE	AT91C_BASE_CS1
+#endif
+
+#if defined(CONFIG_RAM_32MB)
+#define MMU_RAM_SIZE	0x02000000
+#elif defined(CONFIG_RAM_64MB)
+#define MMU_RAM_SIZE	0x04000000
+#elif defined(CONFIG_RAM_128MB)
+#define MMU_RAM_SIZE	0x08000000
+#elif defined(CONFIG_RAM_256MB)
+#define MMU_RAM_SIZE	0x10000000
+#elif defined(CONFIG_RAM_512MB)
+#define MMU_RAM_SIZE	0x20000000
+#else
+#error "No RAM size defined"
+#endif
+
+/*
+ * The populated external RAM: the identity map, the table and the load
+ * bounds of the loaders all use this size.
+ */
+static unsigned int mmu_ram_size(void)
+{
+#ifdef CONFIG_DDR_SIZE_DETECT
+	return ddram_get_size();
+#else
+	return MMU_RAM_SIZE;
+#endif
+}
+
+/*
+ * The table lives in the last 16 KB of the populated external RAM, away
+ * from the ATAGs at the start of it. It only has to survive until
+ * mmu_disable(): the loaders keep the images below it.
+ */
+unsigned int mmu_table_addr(void)
+{
+	return MMU_RAM_BASE + mmu_ram_size() - MMU_TABLE_SIZE;
+}
+
+extern char _stext[];
+
+static void mmu_map_sections(unsigned int *ttb,
+			     unsigned int start,
+			     unsigned int end,
+			     unsigned int attr)
+{
+	unsigned int section;
+
+	for (section = start >> MMU_SECTION_SHIFT;
+	     section <= ((end - 1) >> MMU_SECTION_SHIFT); section++)
+		ttb[section] = (section << MMU_SECTION_SHIFT)
+				| TTB_SECT_ATTR | attr;
+}
+
+void mmu_enable(void)
+{
+	unsigned int *ttb = (unsigned int *)mmu_table_addr();
+
+	mmu_map_sections(ttb, 0, 0xffffffff, TTB_SECT_STRONGLY_ORDERED);
+
+	/* The bootstrap itself: code, data and stack */
+	mmu_map_sections(ttb, (unsigned int)_stext,
+			 TOP_OF_MEMORY, TTB_SECT_NORMAL);
+
+	mmu_map_sections(ttb, MMU_RAM_BASE,
+			 MMU_RAM_BASE + mmu_ram_size(), TTB_SECT_NORMAL);
+
+	mmu_cache_enable(ttb);
+
+	dbg_loud("MMU: I/D caches enabled, table at %x\n",
+		 (unsigned int)ttb);
+
+#ifdef CONFIG_L2CACHE
+	/* Configured and invalidated by l2cache_prepare() in hw_init() */
+	l2cache_enable();
+#endif
+}
+
+void mmu_disable(void)
+{
+#ifdef CONFIG_L2CACHE
+	l2cache_disable();
+#endif
+	mmu_cache_disable();
+}
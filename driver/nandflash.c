@@ -39,6 +39,16 @@
 #include "timer.h"
 #include "fdt.h"
 #include "div.h"
+#include "dma.h"
+#include "secure.h"
+#include "bootstage.h"
+#include "usart.h"
+#include "string.h"
+
+/* Timeouts: the worst case of the datasheets, with some margin */
+#define NAND_TIMEOUT_READY_US	2000	/* tR, tRST: 1 ms at most */
+#define NAND_TIMEOUT_STATUS_US	2000	/* tR, before an on-die ECC status */
+#define NAND_TIMEOUT_ERASE_MS	20	/* tBERS: 10 ms at most */
 
 #ifdef CONFIG_NANDFLASH_SMALL_BLOCKS
 static struct nand_chip nand_ids[] = {
@@ -129,11 +139,15 @@ static unsigned short read_word(void)
 
 static void nand_wait_ready(void)
 {
-	unsigned int timeout = 10000;
+	unsigned long long deadline = timer_deadline_usec(NAND_TIMEOUT_READY_US);
 
 	nand_command(CMD_STATUS);
-	while ((!(read_byte() & STATUS_READY)) && timeout--)
-		;
+	while (!(read_byte() & STATUS_READY)) {
+		if (timer_expired(deadline))
+			break;
+
+		usart_poll();
+	}
 }
 
 static void nand_cs_enable(void)
@@ -329,6 +343,9 @@ static unsigned short onfi_crc16(unsigned short crc,
 #define		PARAMS_FEATURE_BUSWIDTH		(0x1 << 0)
 #define		PARAMS_FEATURE_EXTENDED_PARAM	(0x1 << 7)
 
+#define PARAMS_OFFSET_OPT_CMDS		8
+#define		PARAMS_OPT_CMD_READ_CACHE	(0x1 << 1)
+
 #define PARAMS_OFFSET_EXT_PARAM_PAGE_LEN	12
 #define PARAMS_OFFSET_PARAMETER_PAGE		14
 #define PARAMS_OFFSET_MODEL		49
@@ -404,7 +421,7 @@ static int nandflash_detect_onfi(struct nand_chip *chip)
 	int i, j;
 	unsigned short crc;
 	unsigned char manf_id, dev_id;
-	unsigned short features, revision, ext_page_len;
+	unsigned short features, revision, ext_page_len, opt_cmds;
 	unsigned char num_param_page;
 
 	nand_cs_enable();
@@ -454,6 +471,7 @@ static int nandflash_detect_onfi(struct nand_chip *chip)
 
 	revision = *(unsigned short *)(p + PARAMS_OFFSET_REVISION);
 	features = *(unsigned short *)(p + PARAMS_OFFSET_FEATURES);
+	opt_cmds = *(unsigned short *)(p + PARAMS_OFFSET_OPT_CMDS);
 	ext_page_len = *(unsigned short *)(p +
 					   PARAMS_OFFSET_EXT_PARAM_PAGE_LEN);
 	num_param_page = *(unsigned char *)(p + PARAMS_OFFSET_PARAMETER_PAGE);
@@ -466,6 +484,7 @@ static int nandflash_detect_onfi(struct nand_chip *chip)
 	chip->buswidth	= features & PARAMS_FEATURE_BUSWIDTH;
 	chip->eccbits	= *(unsigned char *)(p + PARAMS_OFFSET_ECC_BITS);
 	chip->eccwordsize = 512;
+	chip->cache_read = (opt_cmds & PARAMS_OPT_CMD_READ_CACHE) ? 1 : 0;
 
 	if ((chip->eccbits == 0xff) &&
 	    (revision & PARAMS_REVISION_2_1) &&
@@ -536,6 +555,7 @@ static int nandflash_detect_non_onfi(struct nand_chip *chip)
 	chip->oobsize	= nand_ids[i].oobsize;
 	chip->buswidth	= nand_ids[i].buswidth;
 	chip->numblocks = nand_ids[i].numblocks;
+	chip->cache_read = 0;
 
 	return 0;
 }
@@ -565,6 +585,8 @@ static int nand_info_init(struct nand_info *nand, struct nand_chip *chip)
 	nand->ecclayout = &nand_oob_layout;
 	/* data bus width (8/16 bits) */
 	nand->buswidth = chip->buswidth;
+	/* sequential cache read, only known from the ONFI parameters */
+	nand->cache_read = chip->cache_read;
 	if (nand->buswidth) {
 		nand->ecclayout->badblockpos *= 2;
 		nand->command = nand_command16;
@@ -651,18 +673,18 @@ static void write_row_address(struct nand_info *nand,
 
 static int nand_read_status(void)
 {
-	unsigned int timeout = 1000;
+	unsigned long long deadline = timer_deadline_usec(NAND_TIMEOUT_STATUS_US);
 	unsigned char status;
 
-	do {
+	while (1) {
 		nand_command(CMD_STATUS);
 		status = read_byte();
 		if (status & STATUS_READY)
 			break;
-	} while (--timeout);
 
-	if (!timeout)
-		return -1;
+		if (timer_expired(deadline))
+			return -1;
+	}
 
 #ifdef CONFIG_ON_DIE_ECC
 	if (status & STATUS_ERROR) {
@@ -821,7 +843,237 @@ static int nand_read_sector(struct nand_info *nand,
 }
 #endif /* #ifdef CONFIG_NANDFLASH_SMALL_BLOCKS */
 
-static int nand_check_badblock(struct nand_info *nand,
+#ifdef CONFIG_NANDFLASH_CACHE_READ
+/*
+ * Sequential cache read: READ CACHE SEQUENTIAL moves the page held in
+ * the cache register to the data register and starts loading the next
+ * one from the array while the host reads the current one out, so only
+ * the first page of a run waits for the whole tR. READ CACHE END moves
+ * the last page without loading another one.
+ *
+ * Sends the command that makes the page @index of the run of @count
+ * pages starting at @row_address ready; the device is busy until
+ * nand_cache_read_wait() returns.
+ */
+static void nand_cache_read_issue(struct nand_info *nand,
+				  unsigned int row_address,
+				  unsigned int index,
+				  unsigned int count)
+{
+	if (index == 0) {
+		nand->command(CMD_READ_1);
+
+		write_column_address(nand, 0);
+		write_row_address(nand, row_address);
+
+		nand->command(CMD_READ_2);
+	} else if (index == count - 1) {
+		nand->command(CMD_READ_CACHE_END);
+	} else {
+		nand->command(CMD_READ_CACHE_SEQ);
+	}
+}
+
+static int nand_cache_read_wait(struct nand_info *nand,
+				unsigned int index,
+				unsigned int count)
+{
+	if (index == 0) {
+		if (nand_read_status())
+			return -1;
+
+		if (index == count - 1)
+			nand->command(CMD_READ_CACHE_END);
+		else
+			nand->command(CMD_READ_CACHE_SEQ);
+	}
+
+	if (nand_read_status())
+		return -1;
+
+	nand->command(CMD_READ_1);
+
+	return 0;
+}
+
+static int nand_cache_read_page(struct nand_info *nand,
+				unsigned int row_address,
+				unsigned int index,
+				unsigned int count)
+{
+	nand_cache_read_issue(nand, row_address, index, count);
+
+	return nand_cache_read_wait(nand, index, count);
+}
+#endif /* #ifdef CONFIG_NANDFLASH_CACHE_READ */
+
+#ifdef CONFIG_NANDFLASH_DMA
+#define NAND_DMA_OOB_MAX	512
+
+/* Spare areas of the page being transferred and of the one being corrected */
+static unsigned char nand_dma_oob[2][NAND_DMA_OOB_MAX]
+					__attribute__((aligned(32)));
+static struct pmecc_page_state nand_dma_pmecc;
+
+static int nand_dma_usable(struct nand_info *nand, unsigned char *buffer)
+{
+	/*
+	 * The destination must start on a cache line, so that correcting
+	 * a page never pulls in a line that the next transfer is writing.
+	 */
+	return !nand->buswidth
+		&& (nand->oobsize <= NAND_DMA_OOB_MAX)
+		&& !((unsigned int)buffer & 0x1f);
+}
+
+/*
+ * First half of a page read: the device starts loading the page from
+ * its array, and stays busy until nand_dma_read_start() has polled it.
+ */
+static void nand_dma_read_issue(struct nand_info *nand,
+				unsigned int row_address,
+				unsigned int index,
+				unsigned int count)
+{
+	pmecc_enable();
+
+#ifdef CONFIG_NANDFLASH_CACHE_READ
+	if (nand->cache_read && (count > 1)) {
+		nand_cache_read_issue(nand, row_address, index, count);
+		return;
+	}
+#endif
+	nand->command(CMD_READ_1);
+
+	write_column_address(nand, 0);
+	write_row_address(nand, row_address + index);
+
+	nand->command(CMD_READ_2);
+}
+
+static int nand_dma_read_start(struct nand_info *nand,
+				unsigned int index,
+				unsigned int count,
+				unsigned char *buffer,
+				unsigned char *oob)
+{
+	struct dma_xfer xfer[2];
+
+#ifdef CONFIG_NANDFLASH_CACHE_READ
+	if (nand->cache_read && (count > 1)) {
+		if (nand_cache_read_wait(nand, index, count))
+			return -1;
+	} else
+#endif
+	{
+		if (nand_read_status())
+			return -1;
+
+		nand->command(CMD_READ_1);
+	}
+
+	pmecc_start_data_phase();
+
+	xfer[0].src = (unsigned int)CONFIG_SYS_NAND_BASE;
+	xfer[0].dst = (unsigned int)buffer;
+	xfer[0].len = nand->pagesize;
+	xfer[1].src = (unsigned int)CONFIG_SYS_NAND_BASE + nand->pagesize;
+	xfer[1].dst = (unsigned int)oob;
+	xfer[1].len = nand->oobsize;
+
+	return dma_start(0, DMA_PERID_NONE, DMA_WIDTH_WORD, xfer, 2);
+}
+
+/*
+ * Read pages by DMA. The PMECC state of a page is saved as soon as its
+ * transfer ends, and the page is corrected while the device loads the
+ * next one from its array.
+ */
+static int nand_dma_read_pages(struct nand_info *nand,
+				unsigned int row_address,
+				unsigned int numpages,
+				unsigned char *buffer)
+{
+	unsigned char *prev = 0;
+	unsigned int slot = 0;
+	unsigned int page;
+	int ret = 0;
+
+	/*
+	 * CE stays asserted over the whole run: a cache read sequence is
+	 * only ended by READ CACHE END, not every device tolerates CE going
+	 * high in between.
+	 */
+	nand_cs_enable();
+
+	for (page = 0; page < numpages; page++) {
+		nand_dma_read_issue(nand, row_address, page, numpages);
+
+		if (prev && pmecc_correct(nand, prev,
+					  nand_dma_oob[slot ^ 1],
+					  &nand_dma_pmecc)) {
+			ret = -1;
+			break;
+		}
+
+		if (nand_dma_read_start(nand, page, numpages,
+					buffer, nand_dma_oob[slot])) {
+			ret = -1;
+			break;
+		}
+
+		if (dma_wait(0)) {
+			ret = -1;
+			break;
+		}
+
+		pmecc_save_state(nand, nand_dma_oob[slot], &nand_dma_pmecc);
+
+		prev = buffer;
+		buffer += nand->pagesize;
+		slot ^= 1;
+	}
+
+	nand_cs_disable();
+
+	if (ret) {
+		pmecc_disable();
+		return -1;
+	}
+
+	if (prev)
+		return pmecc_correct(nand, prev, nand_dma_oob[slot ^ 1],
+				     &nand_dma_pmecc);
+
+	return 0;
+}
+#endif /* #ifdef CONFIG_NANDFLASH_DMA */
+
+/*
+ * Bad block status of the first blocks of the device, filled once per
+ * boot: from the on-flash table when there is one, otherwise as the
+ * blocks are probed.
+ */
+#define NAND_BBT_CACHE_BLOCKS	1024
+
+static unsigned int nand_bbt_known[NAND_BBT_CACHE_BLOCKS / 32];
+static unsigned int nand_bbt_bad[NAND_BBT_CACHE_BLOCKS / 32];
+
+static void nand_bbt_mark(unsigned int block, int bad)
+{
+	unsigned int mask = 1 << (block & 0x1f);
+
+	if (block >= NAND_BBT_CACHE_BLOCKS)
+		return;
+
+	nand_bbt_known[block >> 5] |= mask;
+	if (bad)
+		nand_bbt_bad[block >> 5] |= mask;
+	else
+		nand_bbt_bad[block >> 5] &= ~mask;
+}
+
+static int nand_probe_badblock(struct nand_info *nand,
 				unsigned int block,
 				unsigned char *buffer)
 {
@@ -842,6 +1094,23 @@ static int nand_check_badblock(struct nand_info *nand,
 	return 0;
 }
 
+static int nand_check_badblock(struct nand_info *nand,
+				unsigned int block,
+				unsigned char *buffer)
+{
+	unsigned int mask = 1 << (block & 0x1f);
+	int ret;
+
+	if ((block < NAND_BBT_CACHE_BLOCKS)
+	    && (nand_bbt_known[block >> 5] & mask))
+		return (nand_bbt_bad[block >> 5] & mask) ? -1 : 0;
+
+	ret = nand_probe_badblock(nand, block, buffer);
+	nand_bbt_mark(block, ret);
+
+	return ret;
+}
+
 #ifdef CONFIG_ENABLE_SW_ECC
 static void nand_read_ecc(struct nand_ooblayout *ooblayout,
 				unsigned char *buffer,
@@ -854,6 +1123,23 @@ static void nand_read_ecc(struct nand_ooblayout *ooblayout,
 }
 #endif
 
+#ifdef CONFIG_ENABLE_SW_ECC
+static int nand_verify_hamming(struct nand_info *nand, unsigned char *buffer)
+{
+	unsigned char hamming[48], error;
+
+	nand_read_ecc(nand->ecclayout, buffer + nand->pagesize, hamming);
+
+	error = Hamming_Verify256x(buffer, nand->pagesize, hamming);
+	if (error && (error != Hamming_ERROR_SINGLEBIT)) {
+		dbg_info("NAND: Hamming ECC error!\n");
+		return -1;
+	}
+
+	return 0;
+}
+#endif
+
 static int nand_read_page(struct nand_info *nand,
 				unsigned int block,
 				unsigned int page,
@@ -867,30 +1153,190 @@ static int nand_read_page(struct nand_info *nand,
 #else
 
 	int retval;
-	unsigned char hamming[48], error;
 
 	retval = nand_read_sector(nand, row_address, buffer,
 				ZONE_DATA | ZONE_INFO);
 	if (retval)
 		return -1;
 
-	nand_read_ecc(nand->ecclayout, buffer + nand->pagesize, hamming);
+	return nand_verify_hamming(nand, buffer);
+#endif /* #ifndef CONFIG_ENABLE_SW_ECC */
+}
 
-	error = Hamming_Verify256x(buffer, nand->pagesize, hamming);
-	if (error && (error != Hamming_ERROR_SINGLEBIT)) {
-		dbg_info("NAND: Hamming ECC error!\n");
+#ifdef CONFIG_NANDFLASH_CACHE_READ
+/*
+ * Read a run of pages of a block with the sequential cache read, each
+ * page being checked as nand_read_page() does.
+ */
+static int nand_cache_read_pages(struct nand_info *nand,
+				unsigned int row_address,
+				unsigned int numpages,
+				unsigned char *buffer)
+{
+	unsigned int page, i;
+	unsigned char *pbuf;
+	int ret = 0;
+
+	nand_cs_enable();
+
+	for (page = 0; page < numpages; page++) {
+#ifdef CONFIG_USE_PMECC
+		pmecc_enable();
+#endif
+		ret = nand_cache_read_page(nand, row_address, page, numpages);
+		if (ret)
+			break;
+
+#ifdef CONFIG_USE_PMECC
+		pmecc_start_data_phase();
+#endif
+		pbuf = buffer;
+		if (nand->buswidth) {
+			for (i = 0; i < nand->sectorsize / 2; i++) {
+				*((short *)pbuf) = read_word();
+				pbuf += 2;
+			}
+		} else {
+			for (i = 0; i < nand->sectorsize; i++)
+				*pbuf++ = read_byte();
+		}
+
+#if defined(CONFIG_USE_PMECC)
+		if (!nand->buswidth)
+			ret = pmecc_process(nand, buffer);
+#elif defined(CONFIG_ENABLE_SW_ECC)
+		ret = nand_verify_hamming(nand, buffer);
+#endif
+		if (ret)
+			break;
+
+		buffer += nand->pagesize;
+	}
+
+	nand_cs_disable();
+
+	return ret;
+}
+#endif /* #ifdef CONFIG_NANDFLASH_CACHE_READ */
+
+#ifdef CONFIG_NANDFLASH_BBT
+/*
+ * On-flash bad block table, as written by Linux and U-Boot: it sits in
+ * one of the last NAND_BBT_SCAN_BLOCKS blocks, with a mirror, and holds
+ * two bits per block (0x3: good). The pattern and the version are in
+ * the spare area of the first page, or at the start of its data when
+ * the spare area is used by the ECC.
+ */
+#define NAND_BBT_SCAN_BLOCKS	4
+#define NAND_BBT_OOB_PATTERN	8	/* pattern offset in the spare area */
+#define NAND_BBT_OOB_VERSION	12
+#define NAND_BBT_PATTERN_LEN	4
+
+static const unsigned char nand_bbt_pattern[2][NAND_BBT_PATTERN_LEN] = {
+	{'B', 'b', 't', '0'},	/* main table */
+	{'1', 't', 'b', 'B'},	/* mirror */
+};
+
+static int nand_bbt_match(const unsigned char *buf,
+			  const unsigned char *pattern)
+{
+	unsigned int i;
+
+	for (i = 0; i < NAND_BBT_PATTERN_LEN; i++)
+		if (buf[i] != pattern[i])
+			return 0;
+
+	return 1;
+}
+
+/*
+ * Look for a table in the page 0 of @block.
+ * Returns the offset of the table in the data area, -1 if none.
+ */
+static int nand_bbt_probe(struct nand_info *nand,
+			  unsigned int block,
+			  unsigned char *buffer,
+			  unsigned int *version)
+{
+	unsigned char *oob = buffer + nand->pagesize;
+	unsigned int i;
+
+	if (nand_read_sector(nand, block * nand->pages_block,
+			     buffer, ZONE_INFO))
+		return -1;
+
+	for (i = 0; i < 2; i++) {
+		if (nand_bbt_match(oob + NAND_BBT_OOB_PATTERN,
+				   nand_bbt_pattern[i])) {
+			*version = oob[NAND_BBT_OOB_VERSION];
+			return 0;
+		}
+	}
+
+	if (nand_read_page(nand, block, 0, ZONE_DATA, buffer))
 		return -1;
+
+	for (i = 0; i < 2; i++) {
+		if (nand_bbt_match(buffer, nand_bbt_pattern[i])) {
+			*version = buffer[NAND_BBT_PATTERN_LEN];
+			return NAND_BBT_PATTERN_LEN + 1;
+		}
+	}
+
+	return -1;
+}
+
+static int nand_bbt_load(struct nand_info *nand, unsigned char *buffer)
+{
+	unsigned int block, bbt_block = 0;
+	unsigned int version, bbt_version = 0;
+	unsigned int length, page;
+	unsigned int entry;
+	int offset, bbt_offset = -1;
+
+	for (block = nand->numblocks - NAND_BBT_SCAN_BLOCKS;
+	     block < nand->numblocks; block++) {
+		offset = nand_bbt_probe(nand, block, buffer, &version);
+		if (offset < 0)
+			continue;
+
+		if ((bbt_offset < 0) || (version > bbt_version)) {
+			bbt_block = block;
+			bbt_version = version;
+			bbt_offset = offset;
+		}
+	}
+
+	if (bbt_offset < 0)
+		return -1;
+
+	/* Two bits per block */
+	length = bbt_offset + (nand->numblocks >> 2);
+	for (page = 0; page * nand->pagesize < length; page++) {
+		if (nand_read_page(nand, bbt_block, page, ZONE_DATA,
+				   buffer + page * nand->pagesize))
+			return -1;
+	}
+
+	for (block = 0; (block < nand->numblocks)
+			&& (block < NAND_BBT_CACHE_BLOCKS); block++) {
+		entry = buffer[bbt_offset + (block >> 2)] >> ((block & 0x3) * 2);
+		nand_bbt_mark(block, (entry & 0x3) != 0x3);
 	}
 
+	dbg_info("NAND: Bad block table found in block #%x, version %d\n",
+		 bbt_block, bbt_version);
+
 	return 0;
-#endif /* #ifndef CONFIG_ENABLE_SW_ECC */
 }
+#endif /* #ifdef CONFIG_NANDFLASH_BBT */
 
 #ifdef CONFIG_NANDFLASH_RECOVERY
 static int nand_erase_block0(struct nand_info *nand)
 {
 	unsigned int row_address = 0;
-	unsigned int timeout = 10000;
+	unsigned long long deadline;
+	unsigned int timeout = 0;
 	unsigned int status;
 
 	nand_cs_enable();
@@ -901,16 +1347,21 @@ static int nand_erase_block0(struct nand_info *nand)
 
 	udelay(2000);
 
+	deadline = timer_deadline_msec(NAND_TIMEOUT_ERASE_MS);
 	nand_command(CMD_STATUS);
-	while ((!((status = read_byte()) & STATUS_READY)) && --timeout)
-		;
+	while (!((status = read_byte()) & STATUS_READY)) {
+		if (timer_expired(deadline)) {
+			timeout = 1;
+			break;
+		}
+	}
 
 	nand_cs_disable();
 
 	if (status & STATUS_ERROR)
 		return -1;
 
-	if (timeout == 0)
+	if (timeout)
 		return -2;
 
 	return 0;
@@ -949,6 +1400,7 @@ static int nand_loadimage(struct nand_info *nand,
 				unsigned char *dest)
 {
 	unsigned char *buffer = dest;
+	unsigned char *chunk;
 	unsigned int readsize;
 	unsigned int block = 0;
 	unsigned int page;
@@ -989,6 +1441,29 @@ static int nand_loadimage(struct nand_info *nand,
 		}
 
 		/* read pages of a block */
+		chunk = buffer;
+#ifdef CONFIG_NANDFLASH_DMA
+		if (nand_dma_usable(nand, buffer)) {
+			ret = nand_dma_read_pages(nand,
+					block * nand->pages_block + start_page,
+					numpages, buffer);
+			if (ret)
+				return -1;
+
+			buffer += numpages * nand->pagesize;
+		} else
+#endif
+#ifdef CONFIG_NANDFLASH_CACHE_READ
+		if (nand->cache_read && (numpages > 1)) {
+			ret = nand_cache_read_pages(nand,
+					block * nand->pages_block + start_page,
+					numpages, buffer);
+			if (ret)
+				return -1;
+
+			buffer += numpages * nand->pagesize;
+		} else
+#endif
 		for (page = start_page; page < end_page; page++) {
 			ret = nand_read_page(nand, block, page,
 						ZONE_DATA, buffer);
@@ -997,6 +1472,8 @@ static int nand_loadimage(struct nand_info *nand,
 			else
 				buffer += nand->pagesize;
 		}
+		secure_stream_update(chunk, buffer - chunk);
+		kernel_stream_update(chunk, buffer - chunk);
 		length -= readsize;
 
 		block++;
@@ -1031,6 +1508,33 @@ static int update_image_length(struct nand_info *nand,
 #endif
 	return -1;
 }
+
+/*
+ * update_image_length() has read the first page of the image to head
+ * already: move it to dest if need be, and only read the pages after
+ * it. The bad blocks before the image are skipped again from the bad
+ * block cache.
+ */
+static int nand_loadimage_next(struct nand_info *nand,
+			       unsigned int offset,
+			       unsigned int length,
+			       unsigned char *dest,
+			       unsigned char *head)
+{
+	unsigned int size = nand->pagesize;
+
+	if (size > length)
+		size = length;
+
+	if (dest != head)
+		memmove(dest, head, size);
+
+	if (size == length)
+		return 0;
+
+	return nand_loadimage(nand, offset + size,
+				length - size, dest + size);
+}
 #endif
 
 int load_nandflash(struct image_info *image)
@@ -1053,25 +1557,43 @@ int load_nandflash(struct image_info *image)
 		return -1;
 #endif
 
+#ifdef CONFIG_NANDFLASH_DMA
+	dma_init();
+#endif
+
+#ifdef CONFIG_NANDFLASH_BBT
+	if (nand_bbt_load(&nand, image->dest))
+		dbg_info("NAND: No bad block table, probing the blocks\n");
+#endif
+
 #ifdef CONFIG_ENABLE_SW_ECC
 	dbg_info("NAND: Using Software ECC\n");
 #endif
+	bootstage_mark("media_init");
 
 #if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+	unsigned char *head = image->dest;
 	int length = update_image_length(&nand,
 				image->offset, image->dest, KERNEL_IMAGE);
 	if (length == -1)
 		return -1;
 
 	image->length = length;
+	image->dest = kernel_image_dest(image);
 #endif
 
 	dbg_info("NAND: Image: Copy %x bytes from %x to %x\n",
 			image->length, image->offset, image->dest);
 
+#if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+	ret = nand_loadimage_next(&nand, image->offset,
+				image->length, image->dest, head);
+#else
 	ret = nand_loadimage(&nand, image->offset, image->length, image->dest);
+#endif
 	if (ret)
 		return ret;
+	bootstage_mark("image");
 
 #ifdef CONFIG_OF_LIBFDT
 	length = update_image_length(&nand,
@@ -1084,10 +1606,11 @@ int load_nandflash(struct image_info *image)
 	dbg_info("NAND: dt blob: Copy %x bytes from %x to %x\n",
 		image->of_length, image->of_offset, image->of_dest);
 
-	ret = nand_loadimage(&nand, image->of_offset,
-				image->of_length, image->of_dest);
+	ret = nand_loadimage_next(&nand, image->of_offset,
+				image->of_length, image->of_dest, image->of_dest);
 	if (ret)
 		return ret;
+	bootstage_mark("dtb");
 #endif
 
 	return 0;
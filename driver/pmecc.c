@@ -245,9 +245,8 @@ static void build_gf(unsigned int mm, short *index_of, short *alpha_to)
 			/*  only shift is enabled */
 			alpha_to[i] = alpha_to[i-1] << 1;
 		}
-		/*  lookup table */
-		/* index_of[alpha_to[i]] = i; */
-		index_of[alpha_to[i]] = mod(i, nn);
+		/*  lookup table, alpha ^ nn is alpha ^ 0 */
+		index_of[alpha_to[i]] = (i == nn) ? 0 : i;
 	}
 
 	/* of course index of 0 is undefined in a multiplicative field */
@@ -428,12 +427,17 @@ void pmecc_start_data_phase(void)
 	pmecc_writel(AT91C_PMECC_ENABLE | AT91C_PMECC_DATA, PMECC_CTRL);
 }
 
+void pmecc_disable(void)
+{
+	pmecc_writel(AT91C_PMECC_RST, PMECC_CTRL);
+	pmecc_writel(AT91C_PMECC_DISABLE, PMECC_CTRL);
+}
+
 static int check_pmecc_ecc_data(struct nand_info *nand,
-				unsigned char *buffer)
+				unsigned char *oob)
 {
 	unsigned int i;
-	unsigned char *ecc_data = buffer + nand->pagesize
-				+ nand->ecclayout->eccpos[0];
+	unsigned char *ecc_data = oob + nand->ecclayout->eccpos[0];
 
 	for (i = 0; i < nand->ecclayout->eccbytes; i++)
 		if (*ecc_data++ != 0xff)
@@ -448,24 +452,35 @@ static int check_pmecc_ecc_data(struct nand_info *nand,
 /*
  * \brief Build the pseudo syndromes table
  * \param pPmeccDescriptor Pointer to a PMECC_paramDesc instance.
- * \param sector Targetted sector.
+ * \param pRemainer Remainders of the targetted sector.
  */
 
-static void GenSyn(unsigned long pPMECC,
-		struct _PMECC_paramDesc_struct *pPmeccDescriptor,
-		unsigned int sector)
+static void GenSyn(struct _PMECC_paramDesc_struct *pPmeccDescriptor,
+		short *pRemainer)
 {
-	short *pRemainer;
 	unsigned int index;
 
-	pRemainer = (short *) (pPMECC + PMECC_REM + (sector * 0x40));
-
 	for (index = 0; index < pPmeccDescriptor->tt; index++)
 		/* Fill odd syndromes */
 		pPmeccDescriptor->partialSyn[1 +  (2 * index)]
 						= pRemainer[index];
 }
 
+/*
+ * The logarithms read from index_of[] are below nn, so the sums of two
+ * or three of them are brought back into the alpha_to[] range by a
+ * couple of subtractions rather than by the shift-subtract mod().
+ */
+static inline int gf_log_reduce(int log, int nn)
+{
+	if (log >= nn)
+		log -= nn;
+	if (log >= nn)
+		log -= nn;
+
+	return log;
+}
+
 /**
  * \brief The substitute function evaluates the polynomial remainder,
  * with different values of the field primitive elements.
@@ -474,6 +489,8 @@ static void GenSyn(unsigned long pPMECC,
 static int substitute(struct _PMECC_paramDesc_struct *pPmeccDescriptor)
 {
 	int i, j;
+	int nn = pPmeccDescriptor->nn;
+	unsigned int syn, log;
 	short *si;
 	short *pPartialSyn = pPmeccDescriptor->partialSyn;
 	short *alpha_to = pPmeccDescriptor->alpha_to;
@@ -489,22 +506,27 @@ static int substitute(struct _PMECC_paramDesc_struct *pPmeccDescriptor)
 		si[i] = 0;
 
 	/* Computation 2t syndromes based on S(x) */
-	/* Odd syndromes */
+	/*
+	 * Odd syndromes: the sum of alpha ^ (i * j) over the bits j set in
+	 * the mm-bit remainder. Only the set bits are visited and i * j
+	 * is stepped by i; it stays below (2 * TT_MAX) * mm < nn.
+	 */
 	for (i = 1; i <= 2 * pPmeccDescriptor->tt - 1; i = i + 2) {
 		si[i] = 0;
-		for (j = 0; j < pPmeccDescriptor->mm; j++) {
-			if (pPartialSyn[i] & ((unsigned short)0x1 << j))
-				si[i] = alpha_to[(i * j)] ^ si[i];
+		syn = (unsigned short)pPartialSyn[i] & nn;
+		for (log = 0; syn; syn >>= 1, log += i) {
+			if (syn & 0x1)
+				si[i] ^= alpha_to[log];
 		}
 	}
 	/* Even syndrome = (Odd syndrome) ** 2 */
 	for (i = 2; i <= 2 * pPmeccDescriptor->tt; i = i + 2) {
-		j = i / 2;
+		j = i >> 1;
 		if (si[j] == 0)
 			si[i] = 0;
 		else
-			si[i] = alpha_to[mod((2 * index_of[si[j]]),
-				(unsigned int)pPmeccDescriptor->nn)];
+			si[i] = alpha_to[gf_log_reduce(2 * index_of[si[j]],
+						       nn)];
 	}
 
 	return 0;
@@ -522,6 +544,10 @@ static unsigned int get_sigma(struct _PMECC_paramDesc_struct *pPmeccDescriptor)
 	short *lmu = pPmeccDescriptor->lmu;
 	short *si = pPmeccDescriptor->si;
 	short tt = pPmeccDescriptor->tt;
+	short *alpha_to = pPmeccDescriptor->alpha_to;
+	short *index_of = pPmeccDescriptor->index_of;
+	int nn = pPmeccDescriptor->nn;
+	int log;
 
 	/* mu  */
 	int mu[TT_MAX+1];
@@ -648,12 +674,15 @@ static unsigned int get_sigma(struct _PMECC_paramDesc_struct *pPmeccDescriptor)
 			for (k = 0; k < (2 * TT_MAX+1); k++)
 				pPmeccDescriptor->smu[i+1][k] = 0;
 
-			/* Compute smu[i+1] */
+			/* Compute smu[i+1], log(dmu[i] / dmu[ro]) first */
+			log = gf_log_reduce(index_of[dmu[i]]
+					    + (nn - index_of[dmu[ro]]), nn);
 			for (k = 0; k <= lmu[ro]>>1; k++)
-				if (pPmeccDescriptor->smu[ro][k] && dmu[i])
-					pPmeccDescriptor->smu[i + 1][k + diff] = pPmeccDescriptor->alpha_to[mod((pPmeccDescriptor->index_of[dmu[i]]
-						+ (pPmeccDescriptor->nn	- pPmeccDescriptor->index_of[dmu[ro]])
-						+ pPmeccDescriptor->index_of[pPmeccDescriptor->smu[ro][k]]), (unsigned int)pPmeccDescriptor->nn)];
+				if (pPmeccDescriptor->smu[ro][k])
+					pPmeccDescriptor->smu[i + 1][k + diff] =
+						alpha_to[gf_log_reduce(log
+						+ index_of[pPmeccDescriptor->smu[ro][k]],
+						nn)];
 
 			for (k = 0; k <= lmu[i]>>1; k++)
 				pPmeccDescriptor->smu[i+1][k] ^= pPmeccDescriptor->smu[i][k];
@@ -677,8 +706,10 @@ static unsigned int get_sigma(struct _PMECC_paramDesc_struct *pPmeccDescriptor)
 				 * is null, its index is -1
 				 */
 				else if (pPmeccDescriptor->smu[i+1][k] && si[2 * (i - 1) + 3 - k])
-					dmu[i + 1] = pPmeccDescriptor->alpha_to[mod((pPmeccDescriptor->index_of[pPmeccDescriptor->smu[i + 1][k]]
-							+ pPmeccDescriptor->index_of[si[2 * (i - 1) + 3 - k]]), (unsigned int)pPmeccDescriptor->nn)] ^ dmu[i + 1];
+					dmu[i + 1] = alpha_to[gf_log_reduce(
+						index_of[pPmeccDescriptor->smu[i + 1][k]]
+						+ index_of[si[2 * (i - 1) + 3 - k]],
+						nn)] ^ dmu[i + 1];
 			}
 		}
 	}
@@ -795,22 +826,24 @@ static unsigned int ErrorCorrection(unsigned long pPMERRLOC,
 /**
  * \brief Launch error detection functions and correct corrupted bits.
  * \param pPmeccDescriptor Pointer to a PMECC_paramDesc instance.
- * \param pmeccStatus Value of the PMECC status register.
+ * \param state Saved PMECC status and remainders of the page.
  * \param pageBuffer Base address of the buffer
  *	containing the page to be corrected.
+ * \param oobBuffer Base address of the spare area of the page.
  * \param ErrorNbr Number of error to correct
  * \return 0 if all errors have been corrected, 1 if too many errors detected
  */
-static unsigned int PMECC_CorrectionAlgo(unsigned long pPMECC,
-		unsigned long pPMERRLOC,
+static unsigned int PMECC_CorrectionAlgo(unsigned long pPMERRLOC,
 		struct _PMECC_paramDesc_struct *pPmeccDescriptor,
-		unsigned int pmeccStatus,
-		void *pageBuffer)
+		struct pmecc_page_state *state,
+		void *pageBuffer,
+		void *oobBuffer)
 {
+	unsigned int pmeccStatus = state->erris;
 	unsigned int sectorNumber = 0;
 	unsigned int sectorBaseAddress, eccBaseAddr;
 	volatile int errorNbr;
-	unsigned int sector_num_per_page, page_size_byte, ecc_byte_per_sector;
+	unsigned int sector_num_per_page, ecc_byte_per_sector;
 	/* Get the PMECC sector size and ecc_bits */
 	unsigned int sector_size =
 		pPmeccDescriptor->sectorSize == AT91C_PMECC_SECTORSZ_512 ?
@@ -823,7 +856,6 @@ static unsigned int PMECC_CorrectionAlgo(unsigned long pPMECC,
 	ecc_byte_per_sector = get_pmecc_bytes(sector_size, ecc_bits);
 	sector_num_per_page = div(pPmeccDescriptor->eccSizeByte,
 					ecc_byte_per_sector);
-	page_size_byte = sector_num_per_page * sector_size;
 
 	while (sectorNumber < sector_num_per_page) {
 
@@ -832,12 +864,11 @@ static unsigned int PMECC_CorrectionAlgo(unsigned long pPMECC,
 
 			sectorBaseAddress = (unsigned int)pageBuffer
 					+ (sectorNumber * sector_size);
-			eccBaseAddr = (unsigned int)pageBuffer
-					+ page_size_byte
+			eccBaseAddr = (unsigned int)oobBuffer
 					+ pmecc_readl(PMECC_SADDR)
 					+ (sectorNumber * ecc_byte_per_sector);
 
-			GenSyn(pPMECC, pPmeccDescriptor, sectorNumber);
+			GenSyn(pPmeccDescriptor, state->rem[sectorNumber]);
 
 			substitute(pPmeccDescriptor);
 
@@ -875,20 +906,27 @@ static void buf_dump(unsigned char *buf, int offset, int len)
 	}
 }
 
-static void page_dump(unsigned char *buf, int page_size, int oob_size)
+static void page_dump(unsigned char *buf, unsigned char *oob,
+		      int page_size, int oob_size)
 {
 	dbg_loud("Dump Error Page: Data:\n");
 	buf_dump(buf, 0, page_size);
 	dbg_loud("\nOOB:\n");
-	buf_dump(buf, page_size, oob_size);
+	buf_dump(oob, 0, oob_size);
 	dbg_loud("\n");
 }
 
-int pmecc_process(struct nand_info *nand, unsigned char *buffer)
+/*
+ * Save the status and the remainders of the page just read, so that it
+ * can be corrected after the PMECC has been reset for the next page.
+ */
+void pmecc_save_state(struct nand_info *nand,
+		      unsigned char *oob,
+		      struct pmecc_page_state *state)
 {
-	int ret = 0;
-	int result;
 	unsigned int erris;
+	unsigned int sector, index;
+	short *pRemainer;
 
 	/* waiting for PMECC ready */
 	while (pmecc_readl(PMECC_SR) & AT91C_PMECC_BUSY)
@@ -896,36 +934,69 @@ int pmecc_process(struct nand_info *nand, unsigned char *buffer)
 
 	/* read corrupted bit status */
 	erris = pmecc_readl(PMECC_ISR);
-	if (erris) {
-		if (PMECC_paramDesc.version < AT91C_PMECC_VERSION_SAMA5D4) {
-			if (check_pmecc_ecc_data(nand, buffer) == -1)
-				return 0;
-		}
+	if (erris && (PMECC_paramDesc.version < AT91C_PMECC_VERSION_SAMA5D4)) {
+		/* Erased page */
+		if (check_pmecc_ecc_data(nand, oob) == -1)
+			erris = 0;
+	}
 
-		/* erris means which sector has errors. for example:
-		 * if erris is 0x9 (0b1001)
-		 *                    ^  ^
-		 * the bit 1 indicate the position of error sectors.
-		 * If we have 4 sectors, then that means the first
-		 * and last sector has errors.
-		 */
-		dbg_loud("PMECC: sector bits = %d, bit 1 means corrupted sector, Now correcting...\n", erris);
-		result = PMECC_CorrectionAlgo(AT91C_BASE_PMECC,
-					AT91C_BASE_PMERRLOC,
-					&PMECC_paramDesc,
-					erris,
-					buffer);
-
-		if (result != 0) {
-			dbg_info("PMECC: failed to " \
-					"correct corrupted bits!\n");
-			ret =  -1;
-
-			/* dump the whole page for test */
-			page_dump(buffer, nand->pagesize, nand->oobsize);
-		}
+	state->erris = erris;
+
+	for (sector = 0; erris; sector++, erris >>= 1) {
+		if (!(erris & 0x1))
+			continue;
+
+		pRemainer = (short *)(AT91C_BASE_PMECC + PMECC_REM
+					+ (sector * 0x40));
+		for (index = 0; index < PMECC_paramDesc.tt; index++)
+			state->rem[sector][index] = pRemainer[index];
+	}
+}
+
+int pmecc_correct(struct nand_info *nand,
+		  unsigned char *buffer,
+		  unsigned char *oob,
+		  struct pmecc_page_state *state)
+{
+	int result;
+
+	if (!state->erris)
+		return 0;
+
+	/* erris means which sector has errors. for example:
+	 * if erris is 0x9 (0b1001)
+	 *                    ^  ^
+	 * the bit 1 indicate the position of error sectors.
+	 * If we have 4 sectors, then that means the first
+	 * and last sector has errors.
+	 */
+	dbg_loud("PMECC: sector bits = %d, bit 1 means corrupted sector, Now correcting...\n", state->erris);
+	result = PMECC_CorrectionAlgo(AT91C_BASE_PMERRLOC,
+				&PMECC_paramDesc,
+				state,
+				buffer,
+				oob);
+
+	if (result != 0) {
+		dbg_info("PMECC: failed to " \
+				"correct corrupted bits!\n");
+
+		/* dump the whole page for test */
+		page_dump(buffer, oob, nand->pagesize, nand->oobsize);
+
+		return -1;
 	}
 
-	return ret;
+	return 0;
+}
+
+int pmecc_process(struct nand_info *nand, unsigned char *buffer)
+{
+	static struct pmecc_page_state state;
+	unsigned char *oob = buffer + nand->pagesize;
+
+	pmecc_save_state(nand, oob, &state);
+
+	return pmecc_correct(nand, buffer, oob, &state);
 }
 
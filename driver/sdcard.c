@@ -30,12 +30,21 @@
 #include "board.h"
 
 #include "ff.h"
+#include "string.h"
 
 #include "debug.h"
+#include "secure.h"
+#include "bootstage.h"
 
 #define CHUNK_SIZE	0x40000
+#define HEADER_SIZE	512
 
-static int sdcard_loadimage(char *filename, BYTE *dest)
+/*
+ * When loading a kernel, image is passed: its header is read first, to
+ * find out where the whole image should go, see kernel_image_dest().
+ */
+static int sdcard_loadimage(char *filename, BYTE *dest,
+			    struct image_info *image)
 {
 	FIL 	file;
 	UINT	byte_to_read = CHUNK_SIZE;
@@ -50,12 +59,35 @@ static int sdcard_loadimage(char *filename, BYTE *dest)
 		goto open_fail;
 	}
 
+#if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+	if (image) {
+		byte_read = 0;
+		fret = f_read(&file, (void *)(dest), HEADER_SIZE, &byte_read);
+		secure_stream_update(dest, byte_read);
+		kernel_stream_update(dest, byte_read);
+		if ((fret != FR_OK) || (byte_read < HEADER_SIZE))
+			goto read_done;
+
+		image->dest = kernel_image_dest(image);
+		if (image->dest != dest) {
+			memmove(image->dest, dest, HEADER_SIZE);
+			dest = image->dest;
+		}
+		dest += HEADER_SIZE;
+	}
+#endif
+
 	do {
 		byte_read = 0;
 		fret = f_read(&file, (void *)(dest), byte_to_read, &byte_read);
+		secure_stream_update(dest, byte_read);
+		kernel_stream_update(dest, byte_read);
 		dest += byte_to_read;
 	} while (byte_read >= byte_to_read);
 
+#if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+read_done:
+#endif
 	if (fret != FR_OK) {
 		dbg_info("*** FATFS: f_read: error\n");
 		 ret = -1;
@@ -97,15 +129,21 @@ int load_sdcard(struct image_info *image)
 		dbg_info("*** FATFS: f_mount mount error **\n");
 		return -1;
 	}
+	bootstage_mark("media_init");
 
 	dbg_info("SD/MMC: Image: Read file %s to %x\n",
 					image->filename, image->dest);
 
-	ret = sdcard_loadimage(image->filename, image->dest);
+#if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+	ret = sdcard_loadimage(image->filename, image->dest, image);
+#else
+	ret = sdcard_loadimage(image->filename, image->dest, NULL);
+#endif
 	if (ret) {
 		(void)f_mount(0, NULL);
 		return ret;
 	}
+	bootstage_mark("image");
 
 #ifdef CONFIG_OF_LIBFDT
 	at91_board_set_dtb_name(image->of_filename);
@@ -113,11 +151,12 @@ int load_sdcard(struct image_info *image)
 	dbg_info("SD/MMC: dt blob: Read file %s to %x\n",
 			image->of_filename, image->of_dest);
 
-	ret = sdcard_loadimage(image->of_filename, image->of_dest);
+	ret = sdcard_loadimage(image->of_filename, image->of_dest, NULL);
 	if (ret) {
 		(void)f_mount(0, NULL);
 		return ret;
 	}
+	bootstage_mark("dtb");
 
 #endif
 
@@ -32,6 +32,8 @@
 #include "timer.h"
 #include "debug.h"
 #include "pmc.h"
+#include "mmu.h"
+#include "usart.h"
 
 /*
  * Registers Definitions
@@ -106,6 +108,12 @@
 /*
  * Register Field Definitions
  */
+/* SDMMC_BSR */
+#define	SDMMC_BSR_BLKSIZE	(0x3ff << 0)	/* Transfer Block Size */
+#define	SDMMC_BSR_BOUNDARY	(0x7 << 12)	/* SDMA Buffer Boundary */
+#define		SDMMC_BSR_BOUNDARY_4K		(0x0 << 12)
+#define		SDMMC_BSR_BOUNDARY_512K		(0x7 << 12)
+
 /* SDMMC_TMR */
 #define	SDMMC_TMR_DMAEN		(0x1 << 0)	/* DMA Enable */
 #define	SDMMC_TMR_BCEN		(0x1 << 1)	/* Block Count Enable */
@@ -270,6 +278,47 @@
 #define	SDMMC_HC1R_CARDDTL	(0x1 << 6)	/* Card Detect Test Level */
 #define	SDMMC_HC1R_CARDDSEL	(0x1 << 7)	/* Card Detect Signal Selection */
 
+/* ADMA2 descriptor attributes */
+#define	SDMMC_ADMA2_VALID	(0x1 << 0)	/* Valid */
+#define	SDMMC_ADMA2_END		(0x1 << 1)	/* End of Descriptor Table */
+#define	SDMMC_ADMA2_INT		(0x1 << 2)	/* Interrupt */
+#define	SDMMC_ADMA2_ACT		(0x3 << 4)	/* Action */
+#define		SDMMC_ADMA2_ACT_NOP		(0x0 << 4)
+#define		SDMMC_ADMA2_ACT_TRAN		(0x2 << 4)
+#define		SDMMC_ADMA2_ACT_LINK		(0x3 << 4)
+
+/*---------------------------------------------------------------*/
+
+/* Data transfer modes, from the slowest to the fastest */
+#define	SDHC_XFER_PIO		0
+#define	SDHC_XFER_SDMA		1
+#define	SDHC_XFER_ADMA2		2
+
+#define	SDHC_SDMA_BOUNDARY	0x80000		/* SDMMC_BSR_BOUNDARY_512K */
+
+/* A zero length field stands for 65536 bytes */
+#define	SDHC_ADMA2_DESC_LEN_MAX	0x10000
+#define	SDHC_ADMA2_DESC_COUNT	256		/* up to 16 MiB per command */
+
+/* Timeouts, the data timeout proper is detected by the controller */
+#define	SDHC_TIMEOUT_INHIBIT_US		10000
+#define	SDHC_TIMEOUT_CLOCK_US		20000
+#define	SDHC_TIMEOUT_COMMAND_US		10000
+#define	SDHC_TIMEOUT_CARD_DETECT_MS	50	/* debouncing, up to 13 ms */
+#define	SDHC_TIMEOUT_DATA_MS		10000	/* up to 16 MiB per command */
+
+struct sdhc_adma2_desc {
+	unsigned short	attr;
+	unsigned short	len;
+	unsigned int	addr;
+};
+
+static struct sdhc_adma2_desc sdhc_adma2_table[SDHC_ADMA2_DESC_COUNT]
+					__attribute__((aligned(32)));
+
+/* Best transfer mode reported in the capabilities */
+static unsigned int sdhc_xfer_caps;
+
 /*---------------------------------------------------------------*/
 
 static unsigned int sdhc_get_base(void)
@@ -338,21 +387,28 @@ static void sdhc_set_power(void)
 	sdhc_writeb(SDMMC_PCR, value | SDMMC_PCR_SDBPWR);
 }
 
+static void sdhc_wait_inhibit(void)
+{
+	unsigned long long deadline;
+
+	deadline = timer_deadline_usec(SDHC_TIMEOUT_INHIBIT_US);
+	while (sdhc_readl(SDMMC_PSR) & (SDMMC_PSR_CMDINHC | SDMMC_PSR_CMDINHD)) {
+		if (timer_expired(deadline)) {
+			dbg_info("SDHC: Timeout waiting for CMD and DAT Inhibit bits\n");
+			break;
+		}
+	}
+}
+
 static int sdhc_set_clock(struct sd_card *sdcard, unsigned int clock)
 {
 	struct sd_host *host = sdcard->host;
 	unsigned int clk_gen_sel = 0;
 	unsigned int clk_div;
 	unsigned int reg;
-	unsigned int timeout;
+	unsigned long long deadline;
 
-	timeout = 100000;
-	while ((--timeout) &&
-	       (sdhc_readl(SDMMC_PSR) & (SDMMC_PSR_CMDINHC | SDMMC_PSR_CMDINHD)))
-		;
-
-	if (!timeout)
-		dbg_info("SDHC: Timeout waiting for CMD and DAT Inhibit bits\n");
+	sdhc_wait_inhibit();
 
 	reg = sdhc_readw(SDMMC_CCR);
 	reg &= ~SDMMC_CCR_SDCLKEN;
@@ -390,12 +446,13 @@ static int sdhc_set_clock(struct sd_card *sdcard, unsigned int clock)
 			| (((clk_div >> 8) & SDMMC_CCR_USDCLKFSEL_MSK)
 					< SDMMC_CCR_USDCLKFSEL_OFFSET));
 
-	timeout = 1000000;
-	while ((--timeout) && (!(sdhc_readw(SDMMC_CCR) & SDMMC_CCR_INTCLKS)))
-		;
-
-	if (!timeout)
-		dbg_info("SDHC: Timeout waiting for internal clock ready\n");
+	deadline = timer_deadline_usec(SDHC_TIMEOUT_CLOCK_US);
+	while (!(sdhc_readw(SDMMC_CCR) & SDMMC_CCR_INTCLKS)) {
+		if (timer_expired(deadline)) {
+			dbg_info("SDHC: Timeout waiting for internal clock ready\n");
+			break;
+		}
+	}
 
 	sdhc_writew(SDMMC_CCR, sdhc_readw(SDMMC_CCR) | SDMMC_CCR_SDCLKEN);
 
@@ -454,6 +511,12 @@ static int sdhc_host_capability(struct sd_card *sdcard)
 	if (caps & SDMMC_CA0R_HSSUP)
 		host->caps_high_speed = 1;
 
+	sdhc_xfer_caps = SDHC_XFER_PIO;
+	if (caps & SDMMC_CA0R_SDMASUP)
+		sdhc_xfer_caps = SDHC_XFER_SDMA;
+	if (caps & SDMMC_CA0R_ADMA2SUP)
+		sdhc_xfer_caps = SDHC_XFER_ADMA2;
+
 	host->caps_voltages = 0;
 	if (caps & SDMMC_CA0R_V33VSUP)
 		host->caps_voltages |= SD_OCR_VDD_32_33 | SD_OCR_VDD_33_34;
@@ -474,12 +537,9 @@ static int sdhc_is_card_inserted(struct sd_card *sdcard)
 {
 	/*
 	 * Debouncing of the card detect pin is up to 13ms on sama5d2 rev B
-	 * and later.
-	 * Try to be safe and wait for up to 50ms (50000µs). Let assume
-	 * the PCK (processor clock) frequency is 500MHz, hence 500 cycles/µs.
-	 * 500 * 50000 = 25000000 cycles.
+	 * and later: try to be safe and wait for up to 50ms.
 	 */
-	unsigned int timeout = 25000000;
+	unsigned long long deadline;
 	int is_inserted = 0;
 
 	/*
@@ -498,8 +558,10 @@ static int sdhc_is_card_inserted(struct sd_card *sdcard)
 	}
 
 	/* Poll the Normal Interrupt Status Register for bit 'card inserted'. */
+	deadline = timer_deadline_msec(SDHC_TIMEOUT_CARD_DETECT_MS);
 	while (!(sdhc_readw(SDMMC_NISTR) & SDMMC_NISTR_CINS) &&
-	       timeout--);
+	       !timer_expired(deadline))
+		;
 
 	is_inserted = !!(sdhc_readw(SDMMC_NISTR) & SDMMC_NISTR_CINS);
 
@@ -533,6 +595,7 @@ static int sdhc_init(struct sd_card *sdcard)
 
 	normal_status_mask = SDMMC_NISTR_CMDC
 				| SDMMC_NISTR_TRFC
+				| SDMMC_NISTR_DMAINT
 				| SDMMC_NISTR_BWRRDY
 				| SDMMC_NISTR_BRDRDY;
 	error_status_mask = SDMMC_EISTR_CMDTEO
@@ -541,7 +604,8 @@ static int sdhc_init(struct sd_card *sdcard)
 				| SDMMC_EISTR_CMDIDX
 				| SDMMC_EISTR_DATTEO
 				| SDMMC_EISTR_DATCRC
-				| SDMMC_EISTR_DATEND;
+				| SDMMC_EISTR_DATEND
+				| SDMMC_EISTR_ADMA;
 
 	sdhc_writew(SDMMC_NISTER, normal_status_mask);
 	sdhc_writew(SDMMC_EISTER, error_status_mask);
@@ -558,12 +622,14 @@ static int sdhc_init(struct sd_card *sdcard)
 static int sdhc_read_data(struct sd_data *data)
 {
 	unsigned int normal_status, error_status;
-	unsigned int timeout;
+	unsigned long long deadline;
 	unsigned int i, block = 0;
 	unsigned int *tmp;
 
-	timeout = 1000000;
+	/* Only a guard: the data timeout is detected by the controller */
+	deadline = timer_deadline_msec(SDHC_TIMEOUT_DATA_MS);
 	do {
+		usart_poll();
 		normal_status = sdhc_readw(SDMMC_NISTR);
 
 		sdhc_writew(SDMMC_NISTR, normal_status);
@@ -597,10 +663,106 @@ static int sdhc_read_data(struct sd_data *data)
 				break;
 		}
 
-		if (timeout-- > 0) {
-			udelay(10);
-		} else {
+		if (timer_expired(deadline)) {
+			dbg_info("SDHC: Transfer data timeout\n");
+			return -1;
+		}
+	} while (!(normal_status & SDMMC_NISTR_TRFC));
+
+	return 0;
+}
+
+static unsigned int sdhc_select_xfer(struct sd_data *data)
+{
+	unsigned int len = data->blocks * data->blocksize;
+
+	/* Both DMA engines need a word aligned buffer */
+	if (((unsigned int)data->buff | len) & 0x3)
+		return SDHC_XFER_PIO;
+
+	if ((sdhc_xfer_caps == SDHC_XFER_ADMA2)
+	    && (len <= SDHC_ADMA2_DESC_COUNT * SDHC_ADMA2_DESC_LEN_MAX))
+		return SDHC_XFER_ADMA2;
+
+	if (sdhc_xfer_caps >= SDHC_XFER_SDMA)
+		return SDHC_XFER_SDMA;
+
+	return SDHC_XFER_PIO;
+}
+
+/*
+ * Describe the whole buffer in the ADMA2 table, so that the controller
+ * moves all the blocks of the command without the CPU.
+ */
+static void sdhc_adma2_setup(struct sd_data *data)
+{
+	struct sdhc_adma2_desc *desc = sdhc_adma2_table;
+	unsigned int addr = (unsigned int)data->buff;
+	unsigned int len = data->blocks * data->blocksize;
+	unsigned int size;
+
+	while (len) {
+		size = (len > SDHC_ADMA2_DESC_LEN_MAX) ?
+					SDHC_ADMA2_DESC_LEN_MAX : len;
+
+		desc->attr = SDMMC_ADMA2_VALID | SDMMC_ADMA2_ACT_TRAN;
+		desc->len = size & 0xffff;
+		desc->addr = addr;
+		desc++;
+
+		addr += size;
+		len -= size;
+	}
+	(desc - 1)->attr |= SDMMC_ADMA2_END;
+
+	dcache_clean_range((unsigned int)sdhc_adma2_table, (unsigned int)desc);
+
+	sdhc_writel(SDMMC_ASAR0, (unsigned int)sdhc_adma2_table);
+}
+
+static int sdhc_dma_data(struct sd_data *data, unsigned int xfer)
+{
+	unsigned int normal_status, error_status;
+	unsigned int next_boundary;
+	unsigned long long deadline;
+
+	next_boundary = ((unsigned int)data->buff & ~(SDHC_SDMA_BOUNDARY - 1))
+				+ SDHC_SDMA_BOUNDARY;
+
+	/* Only a guard: the data timeout is detected by the controller */
+	deadline = timer_deadline_msec(SDHC_TIMEOUT_DATA_MS);
+	do {
+		usart_poll();
+		normal_status = sdhc_readw(SDMMC_NISTR);
+
+		sdhc_writew(SDMMC_NISTR, normal_status);
+
+		if (normal_status & SDMMC_NISTR_ERRINT) {
+			error_status = sdhc_readw(SDMMC_EISTR);
+
+			sdhc_writew(SDMMC_EISTR, error_status);
+
+			sdhc_softare_reset_dat();
+
+			if (error_status & SDMMC_EISTR_ADMA)
+				dbg_info("SDHC: ADMA error, status: %x\n",
+					 sdhc_readb(SDMMC_AESR));
+			else
+				dbg_info("SDHC: Error detected in status\n");
+
+			return -1;
+		}
+
+		/* SDMA stops at each buffer boundary */
+		if ((xfer == SDHC_XFER_SDMA)
+		    && (normal_status & SDMMC_NISTR_DMAINT)) {
+			sdhc_writel(SDMMC_SSAR, next_boundary);
+			next_boundary += SDHC_SDMA_BOUNDARY;
+		}
+
+		if (timer_expired(deadline)) {
 			dbg_info("SDHC: Transfer data timeout\n");
+			sdhc_softare_reset_dat();
 			return -1;
 		}
 	} while (!(normal_status & SDMMC_NISTR_TRFC));
@@ -612,17 +774,13 @@ static int sdhc_send_command(struct sd_command *sd_cmd, struct sd_data *data)
 {
 	unsigned int normal_status, error_status, normal_status_mask;
 	unsigned int cmd_reg, mode;
+	unsigned int xfer = SDHC_XFER_PIO;
+	unsigned int len = 0, reg;
 	unsigned int i;
 	int ret;
-	unsigned int timeout;
+	unsigned long long deadline;
 
-	timeout = 100000;
-	while ((--timeout) &&
-	       (sdhc_readl(SDMMC_PSR) & (SDMMC_PSR_CMDINHC | SDMMC_PSR_CMDINHD)))
-		;
-
-	if (!timeout)
-		dbg_info("SDHC: Timeout waiting for CMD and DAT Inhibit bits\n");
+	sdhc_wait_inhibit();
 
 	normal_status_mask =  SDMMC_NISTR_CMDC;
 
@@ -657,8 +815,37 @@ static int sdhc_send_command(struct sd_command *sd_cmd, struct sd_data *data)
 		mode |= (data->blocks > 1) ? SDMMC_TMR_MSBSEL : 0;
 		mode |= (data->direction == SD_DATA_DIR_RD) ? SDMMC_TMR_DTDSEL_READ : 0;
 
+		/* Drop the data events left by the previous transfer */
+		sdhc_writew(SDMMC_NISTR, SDMMC_NISTR_TRFC
+					| SDMMC_NISTR_DMAINT
+					| SDMMC_NISTR_BWRRDY
+					| SDMMC_NISTR_BRDRDY);
+
+		xfer = sdhc_select_xfer(data);
+		if (xfer != SDHC_XFER_PIO) {
+			len = data->blocks * data->blocksize;
+			if (data->direction == SD_DATA_DIR_RD)
+				dcache_invalidate_range((unsigned int)data->buff,
+					(unsigned int)data->buff + len);
+			else
+				dcache_clean_range((unsigned int)data->buff,
+					(unsigned int)data->buff + len);
+
+			reg = sdhc_readb(SDMMC_HC1R) & ~SDMMC_HC1R_DMASEL;
+			if (xfer == SDHC_XFER_ADMA2) {
+				sdhc_adma2_setup(data);
+				reg |= SDMMC_HC1R_DMASEL_ADMA32;
+			} else {
+				sdhc_writel(SDMMC_SSAR, (unsigned int)data->buff);
+				reg |= SDMMC_HC1R_DMASEL_SDMA;
+			}
+			sdhc_writeb(SDMMC_HC1R, reg);
+
+			mode |= SDMMC_TMR_DMAEN;
+		}
+
 		sdhc_writeb(SDMMC_TCR, 0xe);
-		sdhc_writew(SDMMC_BSR, data->blocksize);
+		sdhc_writew(SDMMC_BSR, data->blocksize | SDMMC_BSR_BOUNDARY_512K);
 		if (data->blocks > 1)
 			sdhc_writew(SDMMC_BCR, data->blocks);
 		sdhc_writew(SDMMC_TMR, mode);
@@ -668,18 +855,21 @@ static int sdhc_send_command(struct sd_command *sd_cmd, struct sd_data *data)
 
 	sdhc_writew(SDMMC_CR, cmd_reg);
 
-	timeout = 100000;
+	deadline = timer_deadline_usec(SDHC_TIMEOUT_COMMAND_US);
 	do {
+		usart_poll();
 		normal_status = sdhc_readw(SDMMC_NISTR);
 		if (normal_status & SDMMC_NISTR_ERRINT)
 			break;
-	} while ((--timeout) &&
-		 ((normal_status & normal_status_mask) != normal_status_mask));
-
-	if (!timeout)
-		dbg_info("SDHC: Timeout waiting for command complete\n");
+		if (((normal_status & normal_status_mask) != normal_status_mask)
+		    && timer_expired(deadline)) {
+			dbg_info("SDHC: Timeout waiting for command complete\n");
+			break;
+		}
+	} while ((normal_status & normal_status_mask) != normal_status_mask);
 
-	sdhc_writew(SDMMC_NISTR, normal_status);
+	/* Keep the data events for the transfer loop */
+	sdhc_writew(SDMMC_NISTR, normal_status & normal_status_mask);
 
 	if ((normal_status & normal_status_mask) == normal_status_mask) {
 		if (sd_cmd->resp_type == SD_RESP_TYPE_R2) {
@@ -689,10 +879,20 @@ static int sdhc_send_command(struct sd_command *sd_cmd, struct sd_data *data)
 			*sd_cmd->resp = sdhc_readl(SDMMC_RR0);
 		}
 
-		if (data)
-			sdhc_read_data(data);
-
 		ret = 0;
+		if (data) {
+			if (xfer == SDHC_XFER_PIO) {
+				ret = sdhc_read_data(data);
+			} else {
+				ret = sdhc_dma_data(data, xfer);
+
+				/* Drop the lines fetched during the transfer */
+				if (data->direction == SD_DATA_DIR_RD)
+					dcache_invalidate_range(
+						(unsigned int)data->buff,
+						(unsigned int)data->buff + len);
+			}
+		}
 	} else {
 		error_status = sdhc_readw(SDMMC_EISTR);
 
@@ -125,18 +125,335 @@ exit:
 	return rc;
 }
 
+#ifdef CPU_HAS_AES_GCM
+#define secure_is_gcm(header)	((header)->magic == AT91_SECURE_MAGIC_GCM)
+
+static void secure_gcm_iv(const at91_secure_header_t *header,
+			  const unsigned int *iv,
+			  unsigned int *gcm_iv)
+{
+	gcm_iv[0] = header->nonce[0];
+	gcm_iv[1] = header->nonce[1];
+	gcm_iv[2] = iv[0];
+}
+
+/*
+ * Authenticate and decrypt the file in a single pass; the secure header
+ * in front of it is the additional authenticated data.
+ */
+static int secure_decrypt_gcm(void *data, const at91_secure_header_t *header)
+{
+	at91_aes_key_size_t key_size;
+	unsigned int cmac_key[8], cipher_key[8];
+	unsigned int iv[AT91_AES_IV_SIZE_WORD];
+	unsigned int gcm_iv[AT91_AES_GCM_IV_SIZE_WORD];
+	unsigned int computed_tag[AT91_AES_BLOCK_SIZE_WORD];
+	unsigned int fixed_length = at91_aes_roundup(header->file_size);
+	int rc = -1;
+
+	if (!header->file_size)
+		return -1;
+
+	/* Init keys */
+	init_keys(&key_size, cipher_key, cmac_key, iv);
+	secure_gcm_iv(header, iv, gcm_iv);
+
+	/* Init periph */
+	at91_aes_init();
+
+	if (at91_aes_gcm(fixed_length, data, data, key_size, cipher_key,
+			 gcm_iv, header, sizeof(*header), computed_tag))
+		goto exit;
+
+	/* Check the tag, do not leave out the plain text if it is wrong */
+	if (memcmp((char *)data + fixed_length, computed_tag,
+		   AT91_AES_BLOCK_SIZE_BYTE)) {
+		memset(data, 0, fixed_length);
+		goto exit;
+	}
+
+	rc = 0;
+exit:
+	/* Reset periph */
+	at91_aes_cleanup();
+
+	/* Reset keys */
+	memset(cmac_key, 0, sizeof(cmac_key));
+	memset(cipher_key, 0, sizeof(cipher_key));
+	memset(iv, 0, sizeof(iv));
+	memset(gcm_iv, 0, sizeof(gcm_iv));
+
+	return rc;
+}
+#else
+#define secure_is_gcm(header)	0
+#endif /* #ifdef CPU_HAS_AES_GCM */
+
+#ifdef CONFIG_SECURE_STREAM
+/*
+ * Streaming check: the loaders report each chunk of the image as it
+ * lands, and its whole AES blocks are processed in place right away.
+ *
+ * CMAC+CBC images: the blocks are authenticated then decrypted, the
+ * CMAC and CBC chaining values being carried from a chunk to the next
+ * one. The last block of the file is kept for secure_check(), which
+ * completes the CMAC and compares it before decrypting that block.
+ *
+ * GCM images: the engine runs the whole message, the chunks being fed
+ * to it as they come; secure_check() only has to compare the tag.
+ */
+#define SECURE_STREAM_IDLE	0
+#define SECURE_STREAM_HEADER	1
+#define SECURE_STREAM_FILE	2
+#define SECURE_STREAM_ERROR	3
+
+struct secure_stream {
+	unsigned int	state;
+	unsigned int	gcm;		/* GCM image */
+	unsigned char	*base;		/* secure header */
+	unsigned char	*loaded;	/* end of the data reported so far */
+	unsigned char	*file;		/* first block of the file */
+	unsigned char	*pos;		/* next block to process */
+	unsigned char	*last;		/* last block of the file */
+	unsigned char	*end;		/* end of the blocks to stream */
+	unsigned int	cmac[AT91_AES_BLOCK_SIZE_WORD];
+	unsigned int	iv[AT91_AES_IV_SIZE_WORD];
+};
+
+static struct secure_stream stream;
+
+static int secure_stream_header(struct secure_stream *s)
+{
+	const at91_secure_header_t *header;
+	at91_aes_key_size_t key_size;
+	unsigned int cmac_key[8], cipher_key[8];
+	unsigned int fixed_length;
+	int rc = 0;
+
+	if (secure_decrypt(s->base, sizeof(*header), 0))
+		return -1;
+
+	header = (const at91_secure_header_t *)s->base;
+	s->gcm = secure_is_gcm(header);
+	if (((header->magic != AT91_SECURE_MAGIC) && !s->gcm)
+	    || !header->file_size)
+		return -1;
+
+	fixed_length = at91_aes_roundup(header->file_size);
+	s->file = s->base + sizeof(*header);
+	s->pos = s->file;
+	s->last = s->file + fixed_length - AT91_AES_BLOCK_SIZE_BYTE;
+	s->end = s->gcm ? s->file + fixed_length : s->last;
+	memset(s->cmac, 0, sizeof(s->cmac));
+
+	/* The CBC chain of the file starts from the configured IV */
+	init_keys(&key_size, cipher_key, cmac_key, s->iv);
+
+#ifdef CPU_HAS_AES_GCM
+	/* The GCM engine is kept running until the tag is read */
+	if (s->gcm) {
+		unsigned int gcm_iv[AT91_AES_GCM_IV_SIZE_WORD];
+
+		secure_gcm_iv(header, s->iv, gcm_iv);
+
+		at91_aes_init();
+		rc = at91_aes_gcm_start(key_size, cipher_key, gcm_iv,
+					header, sizeof(*header), fixed_length);
+
+		memset(gcm_iv, 0, sizeof(gcm_iv));
+	}
+#endif
+
+	memset(cmac_key, 0, sizeof(cmac_key));
+	memset(cipher_key, 0, sizeof(cipher_key));
+
+	return rc;
+}
+
+/* Authenticate and decrypt the blocks from s->pos up to @end */
+static int secure_stream_blocks(struct secure_stream *s, unsigned char *end)
+{
+	at91_aes_key_size_t key_size;
+	unsigned int cmac_key[8], cipher_key[8];
+	unsigned int iv[AT91_AES_IV_SIZE_WORD];
+	unsigned int next_iv[AT91_AES_IV_SIZE_WORD];
+	unsigned int length = end - s->pos;
+	int rc = -1;
+
+#ifdef CPU_HAS_AES_GCM
+	if (s->gcm) {
+		if (at91_aes_gcm_update(length, s->pos, s->pos))
+			return -1;
+		s->pos = end;
+		return 0;
+	}
+#endif
+
+	init_keys(&key_size, cipher_key, cmac_key, iv);
+
+	at91_aes_init();
+
+	if (at91_aes_cmac_update(length, s->pos, s->cmac,
+				 key_size, cmac_key))
+		goto exit;
+
+	/* The last cipher block of the chunk chains into the next one */
+	memcpy(next_iv, end - AT91_AES_BLOCK_SIZE_BYTE, sizeof(next_iv));
+
+	if (at91_aes_cbc(length, s->pos, s->pos, 0,
+			 key_size, cipher_key, s->iv))
+		goto exit;
+
+	memcpy(s->iv, next_iv, sizeof(next_iv));
+	s->pos = end;
+
+	rc = 0;
+exit:
+	at91_aes_cleanup();
+
+	memset(cmac_key, 0, sizeof(cmac_key));
+	memset(cipher_key, 0, sizeof(cipher_key));
+	memset(iv, 0, sizeof(iv));
+
+	return rc;
+}
+
+static void secure_stream_process(struct secure_stream *s)
+{
+	unsigned char *end;
+
+	if (s->state == SECURE_STREAM_HEADER) {
+		if (s->loaded < s->base + sizeof(at91_secure_header_t))
+			return;
+
+		if (secure_stream_header(s)) {
+			s->state = SECURE_STREAM_ERROR;
+			return;
+		}
+
+		s->state = SECURE_STREAM_FILE;
+	}
+
+	if (s->state != SECURE_STREAM_FILE)
+		return;
+
+	end = (s->loaded < s->end) ? s->loaded : s->end;
+	end -= (end - s->pos) & (AT91_AES_BLOCK_SIZE_BYTE - 1);
+	if (end > s->pos) {
+		if (secure_stream_blocks(s, end))
+			s->state = SECURE_STREAM_ERROR;
+	}
+}
+
+void secure_stream_start(void *data)
+{
+	memset(&stream, 0, sizeof(stream));
+
+	stream.state = SECURE_STREAM_HEADER;
+	stream.base = (unsigned char *)data;
+	stream.loaded = stream.base;
+}
+
+void secure_stream_update(const void *data, unsigned int length)
+{
+	if (stream.state == SECURE_STREAM_IDLE)
+		return;
+
+	/* The image is read again from its start, e.g. after its length */
+	if (data == stream.base) {
+		stream.state = SECURE_STREAM_HEADER;
+		stream.loaded = stream.base;
+	}
+
+	/* Only contiguous chunks, the rest is done by secure_check() */
+	if (data != stream.loaded)
+		return;
+
+	stream.loaded += length;
+	secure_stream_process(&stream);
+}
+
+static int secure_stream_finish(struct secure_stream *s)
+{
+	at91_aes_key_size_t key_size;
+	unsigned int cmac_key[8], cipher_key[8];
+	unsigned int iv[AT91_AES_IV_SIZE_WORD];
+	int rc = -1;
+
+	/* Whatever was not reported by the loader is in memory by now */
+	s->loaded = (unsigned char *)~0UL;
+	secure_stream_process(s);
+	if (s->state != SECURE_STREAM_FILE)
+		goto exit_stream;
+
+#ifdef CPU_HAS_AES_GCM
+	if (s->gcm) {
+		unsigned int tag[AT91_AES_BLOCK_SIZE_WORD];
+
+		if (!at91_aes_gcm_final(tag) &&
+		    !memcmp(s->end, tag, AT91_AES_BLOCK_SIZE_BYTE))
+			rc = 0;
+		goto exit_stream;
+	}
+#endif
+
+	init_keys(&key_size, cipher_key, cmac_key, iv);
+
+	at91_aes_init();
+
+	if (at91_aes_cmac_final(s->last, s->cmac, key_size, cmac_key))
+		goto exit;
+
+	if (memcmp(s->last + AT91_AES_BLOCK_SIZE_BYTE, s->cmac,
+		   AT91_AES_BLOCK_SIZE_BYTE))
+		goto exit;
+
+	if (at91_aes_cbc(AT91_AES_BLOCK_SIZE_BYTE, s->last, s->last, 0,
+			 key_size, cipher_key, s->iv))
+		goto exit;
+
+	rc = 0;
+exit:
+	memset(cmac_key, 0, sizeof(cmac_key));
+	memset(cipher_key, 0, sizeof(cipher_key));
+	memset(iv, 0, sizeof(iv));
+
+exit_stream:
+	at91_aes_cleanup();
+
+	/* Do not leave out what was decrypted before the check */
+	if (rc && s->file)
+		memset(s->file, 0, s->pos - s->file);
+
+	memset(s, 0, sizeof(*s));
+
+	return rc;
+}
+#endif /* #ifdef CONFIG_SECURE_STREAM */
+
 int secure_check(void *data)
 {
 	const at91_secure_header_t *header;
 	void *file;
 
+#ifdef CONFIG_SECURE_STREAM
+	if ((stream.state != SECURE_STREAM_IDLE) && (data == stream.base))
+		return secure_stream_finish(&stream);
+#endif
+
 	if (secure_decrypt(data, sizeof(*header), 0))
 		return -1;
 
 	header = (const at91_secure_header_t *)data;
+	file = (unsigned char *)data + sizeof(*header);
+
+#ifdef CPU_HAS_AES_GCM
+	if (secure_is_gcm(header))
+		return secure_decrypt_gcm(file, header);
+#endif
+
 	if (header->magic != AT91_SECURE_MAGIC)
 		return -1;
 
-	file = (unsigned char *)data + sizeof(*header);
 	return secure_decrypt(file, header->file_size, 1);
 }
@@ -32,6 +32,7 @@
 #include "arch/at91_pio.h"
 #include "gpio.h"
 #include "string.h"
+#include "bootstage.h"
 #include "timer.h"
 #include "div.h"
 #include "fdt.h"
@@ -91,6 +92,7 @@ static int df_send_command(unsigned char *cmd,
 				unsigned int data_len)
 {
 	int i;
+	int ret = 0;
 
 	if (!cmd)
 		return -1;
@@ -112,13 +114,12 @@ static int df_send_command(unsigned char *cmd,
 		at91_spi_read_spi();
 	}
 
-	for (i = 0; i < data_len; i++) {
-		at91_spi_write_data(0);
-		*data++ = at91_spi_read_spi();
-	}
+	if (data_len)
+		ret = at91_spi_read_data(data, data_len);
+
 	at91_spi_cs_deactivate();
 
-	return 0;
+	return ret;
 }
 
 static int dataflash_read_array(struct dataflash_descriptor *df_desc,
@@ -228,6 +229,30 @@ static int update_image_length(struct dataflash_descriptor *df_desc,
 #endif
 	return -1;
 }
+
+/*
+ * update_image_length() has read the first page of the image to head
+ * already: move it to dest if need be, and only read what follows.
+ */
+static int read_image_next(struct dataflash_descriptor *df_desc,
+			   unsigned int offset,
+			   unsigned int length,
+			   unsigned char *dest,
+			   unsigned char *head)
+{
+	unsigned int size = df_desc->page_size;
+
+	if (size > length)
+		size = length;
+
+	if (dest != head)
+		memmove(dest, head, size);
+
+	if (size == length)
+		return 0;
+
+	return read_array(df_desc, offset + size, length - size, dest + size);
+}
 #endif
 
 static unsigned char df_read_status_at45(unsigned char *status)
@@ -693,25 +718,34 @@ int spi_flash_loadimage(struct image_info *image)
 		goto err_exit;
 	}
 #endif
+	bootstage_mark("media_init");
 
 #if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+	unsigned char *head = image->dest;
 	int length = update_image_length(df_desc,
 				image->offset, image->dest, KERNEL_IMAGE);
 	if (length == -1)
 		return -1;
 
 	image->length = length;
+	image->dest = kernel_image_dest(image);
 #endif
 
 	dbg_info("SF: Copy %x bytes from %x to %x\n",
 			image->length, image->offset, image->dest);
 
+#if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+	ret = read_image_next(df_desc, image->offset,
+				image->length, image->dest, head);
+#else
 	ret = read_array(df_desc, image->offset, image->length, image->dest);
+#endif
 	if (ret) {
 		dbg_info("** SF: Serial flash read error**\n");
 		ret = -1;
 		goto err_exit;
 	}
+	bootstage_mark("image");
 
 #ifdef CONFIG_OF_LIBFDT
 	length = update_image_length(df_desc,
@@ -724,13 +758,14 @@ int spi_flash_loadimage(struct image_info *image)
 	dbg_info("SF: dt blob: Copy %x bytes from %x to %x\n",
 		image->of_length, image->of_offset, image->of_dest);
 
-	ret = read_array(df_desc,
-		image->of_offset, image->of_length, image->of_dest);
+	ret = read_image_next(df_desc, image->of_offset,
+			image->of_length, image->of_dest, image->of_dest);
 	if (ret) {
 		dbg_info("** SF: DT: Serial flash read error**\n");
 		ret = -1;
 		goto err_exit;
 	}
+	bootstage_mark("dtb");
 #endif
 
 err_exit:
@@ -30,10 +30,13 @@
 #include "spi_flash/sfdp.h"
 #include "debug.h"
 #include "board.h"
+#include "arch/at91_pio.h"
 #include "gpio.h"
 #include "timer.h"
 #include "div.h"
 #include "fdt.h"
+#include "string.h"
+#include "bootstage.h"
 
 int spi_flash_read_reg(struct spi_flash *flash, u8 inst, u8 *buf, size_t len)
 {
@@ -209,7 +212,7 @@ int spi_flash_setup(struct spi_flash *flash,
 }
 
 #if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
-static int update_image_length(spi_flash_t *flash,
+static int update_image_length(struct spi_flash *flash,
 			       unsigned int offset,
 			       unsigned char *dest,
 			       unsigned char flag)
@@ -232,6 +235,30 @@ static int update_image_length(spi_flash_t *flash,
 #endif
 	return -1;
 }
+
+/*
+ * update_image_length() has read the first page of the image to head
+ * already: move it to dest if need be, and only read what follows.
+ */
+static int spi_flash_read_next(struct spi_flash *flash,
+			       unsigned int offset,
+			       unsigned int length,
+			       unsigned char *dest,
+			       unsigned char *head)
+{
+	unsigned int size = flash->page_size;
+
+	if (size > length)
+		size = length;
+
+	if (dest != head)
+		memmove(dest, head, size);
+
+	if (size == length)
+		return 0;
+
+	return spi_flash_read(flash, offset + size, length - size, dest + size);
+}
 #endif
 
 #ifdef CONFIG_QSPI_XIP
@@ -317,6 +344,7 @@ int spi_flash_loadimage(struct spi_flash *flash, struct image_info *image)
 		goto err_exit;
 	}
 #endif /* CONFIG_DATAFLASH_RECOVERY */
+	bootstage_mark("media_init");
 
 #ifdef CONFIG_OF_LIBFDT
 	length = update_image_length(flash,
@@ -332,15 +360,17 @@ int spi_flash_loadimage(struct spi_flash *flash, struct image_info *image)
 
 	dbg_info("SF: dt blob: Copy %x bytes from %x to %x\n",
 		 image->of_length, image->of_offset, image->of_dest);
-	ret = spi_flash_read(flash,
-			     image->of_offset,
-			     image->of_length,
-			     image->of_dest);
+	ret = spi_flash_read_next(flash,
+				  image->of_offset,
+				  image->of_length,
+				  image->of_dest,
+				  image->of_dest);
 	if (ret) {
 		dbg_info("** SF: DT: Serial flash read error**\n");
 		ret = -1;
 		goto err_exit;
 	}
+	bootstage_mark("dtb");
 #endif /* CONFIG_OF_LIBFDT */
 
 #ifdef CONFIG_QSPI_XIP
@@ -356,6 +386,8 @@ int spi_flash_loadimage(struct spi_flash *flash, struct image_info *image)
 #else /* CONFIG_QSPI_XIP */
 
 #if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+	unsigned char *head = image->dest;
+
 	length = update_image_length(flash,
 				     image->offset,
 				     image->dest,
@@ -366,19 +398,29 @@ int spi_flash_loadimage(struct spi_flash *flash, struct image_info *image)
 	}
 
 	image->length = length;
+	image->dest = kernel_image_dest(image);
 #endif
 
 	dbg_info("SF: Copy %x bytes from %x to %x\n",
 		 image->length, image->offset, image->dest);
+#if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+	ret = spi_flash_read_next(flash,
+				  image->offset,
+				  image->length,
+				  image->dest,
+				  head);
+#else
 	ret = spi_flash_read(flash,
 			     image->offset,
 			     image->length,
 			     image->dest);
+#endif
 	if (ret) {
 		dbg_info("** SF: Serial flash read error**\n");
 		ret = -1;
 		goto err_exit;
 	}
+	bootstage_mark("image");
 #endif /* !CONFIG_QSPI_XIP */
 
 err_exit:
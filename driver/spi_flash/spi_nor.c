@@ -377,6 +377,7 @@ int spi_nor_probe(struct spi_flash *flash,
 	flash->write = spi_nor_write;
 	flash->erase = spi_nor_erase;
 	flash->flags = 0;
+	flash->max_freq = 0;
 	flash->normal_mode = 0xFFu;
 	flash->xip_mode = 0xA5u;
 
@@ -388,6 +389,8 @@ int spi_nor_probe(struct spi_flash *flash,
 	if (info->flags & SNOR_HAS_FSR)
 		flash->flags |= SFLASH_FLG_HAS_FSR;
 
+	flash->max_freq = info->max_freq;
+
 	if (info->flags & SNOR_SST_ULBPR)
 		if (sst26_unlock_block_protection(flash))
 			dbg_info("SF: WARNING: SST26 - can't unlock block protection\n");
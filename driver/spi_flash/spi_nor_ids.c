@@ -44,6 +44,7 @@
 	.sector_size = 4096U,			\
 	.n_sectors = (_n_sectors),		\
 	.page_size = 256,			\
+	.max_freq = 104000000,			\
 	.flags = SNOR_SECT_4K_ONLY | SNOR_SST_ULBPR
 
 #define N25Q(_name, _jedec_id, _n_sectors)	\
@@ -52,6 +53,7 @@
 	.sector_size = 65536U,			\
 	.n_sectors = (_n_sectors),		\
 	.page_size = 256,			\
+	.max_freq = 108000000,			\
 	.flags = SNOR_HAS_FSR | SNOR_SECT_4K | SNOR_NO_4BAIS
 
 const struct spi_nor_info spi_nor_ids[] = {
@@ -0,0 +1,4 @@
+/*
+ * Empty board header for the host builds, the target sources only need
+ * the SoC definitions selected on the command line.
+ */
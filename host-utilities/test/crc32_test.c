@@ -0,0 +1,197 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2017, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*
+ * Host check and benchmark of lib/crc32.c, built once with the
+ * slice-by-8 tables and once with the bytewise table only: known CRC-32
+ * vectors, random buffers at every alignment fed whole and in random
+ * pieces against a bit-at-a-time reference, then the MB/s of both.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+extern unsigned int crc32_slice8(unsigned int crc, const void *buf,
+				 unsigned int len);
+extern unsigned int crc32_bytewise(unsigned int crc, const void *buf,
+				   unsigned int len);
+
+#define BUF_SIZE	(64 * 1024)
+#define BENCH_BYTES	(256 << 20)
+
+typedef unsigned int (*crc_fn)(unsigned int, const void *, unsigned int);
+
+static const struct {
+	const char *name;
+	crc_fn fn;
+} impls[] = {
+	{"slice-by-8", crc32_slice8},
+	{"bytewise", crc32_bytewise},
+};
+
+#define NR_IMPLS	(sizeof(impls) / sizeof(impls[0]))
+
+static const struct {
+	const char *data;
+	unsigned int len;
+	unsigned int crc;
+} vectors[] = {
+	{"", 0, 0x00000000},
+	{"a", 1, 0xe8b7be43},
+	{"abc", 3, 0x352441c2},
+	{"123456789", 9, 0xcbf43926},
+	{"The quick brown fox jumps over the lazy dog", 43, 0x414fa339},
+	{"\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0"
+	 "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0", 32, 0x190a55ad},
+	{"\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff"
+	 "\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff",
+	 32, 0xff6cab0b},
+};
+
+static unsigned char buf[BUF_SIZE + 8];
+
+static unsigned int rnd_state = 0x9e3779b9;
+
+static unsigned int rnd(void)
+{
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 17;
+	rnd_state ^= rnd_state << 5;
+
+	return rnd_state;
+}
+
+static unsigned int crc32_bitwise(const unsigned char *p, unsigned int len)
+{
+	unsigned int crc = 0xffffffff;
+	int k;
+
+	while (len--) {
+		crc ^= *p++;
+		for (k = 0; k < 8; k++)
+			crc = (crc >> 1) ^ ((crc & 1) ? 0xedb88320 : 0);
+	}
+
+	return ~crc;
+}
+
+static int check(void)
+{
+	unsigned int i, j, off, len, done, piece, crc, want;
+
+	for (i = 0; i < NR_IMPLS; i++) {
+		for (j = 0; j < sizeof(vectors) / sizeof(vectors[0]); j++) {
+			crc = impls[i].fn(0, vectors[j].data, vectors[j].len);
+			if (crc != vectors[j].crc) {
+				printf("%s: vector %u: %08x, expected %08x\n",
+				       impls[i].name, j, crc, vectors[j].crc);
+				return -1;
+			}
+		}
+	}
+
+	for (j = 0; j < sizeof(buf); j++)
+		buf[j] = rnd();
+
+	for (j = 0; j < 2000; j++) {
+		off = j & 7;
+		len = (j < 200) ? j : rnd() % (BUF_SIZE - 8);
+		want = crc32_bitwise(buf + off, len);
+
+		for (i = 0; i < NR_IMPLS; i++) {
+			crc = impls[i].fn(0, buf + off, len);
+			if (crc != want) {
+				printf("%s: %u bytes at +%u: %08x, expected %08x\n",
+				       impls[i].name, len, off, crc, want);
+				return -1;
+			}
+
+			/* in pieces, as the kernel stream feeds it */
+			crc = 0;
+			for (done = 0; done < len; done += piece) {
+				piece = 1 + rnd() % 4096;
+				if (piece > len - done)
+					piece = len - done;
+				crc = impls[i].fn(crc, buf + off + done, piece);
+			}
+			if (crc != want) {
+				printf("%s: %u bytes at +%u in pieces: %08x, expected %08x\n",
+				       impls[i].name, len, off, crc, want);
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static double now_s(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void bench(void)
+{
+	static const unsigned int lens[] = {64, 4096, BUF_SIZE};
+	unsigned int i, j, n, loops;
+	unsigned int crc = 0;
+	double start, rate;
+
+	printf("%-12s %8s %10s\n", "crc32", "bytes", "MB/s");
+	for (i = 0; i < NR_IMPLS; i++) {
+		for (j = 0; j < sizeof(lens) / sizeof(lens[0]); j++) {
+			loops = BENCH_BYTES / lens[j];
+			start = now_s();
+			for (n = 0; n < loops; n++)
+				crc = impls[i].fn(crc, buf, lens[j]);
+			rate = (double)loops * lens[j] / (now_s() - start)
+			       / (1 << 20);
+			printf("%-12s %8u %10.0f\n", impls[i].name, lens[j], rate);
+		}
+	}
+
+	/* the result is used, the loops stay */
+	if (crc == 0x12345678)
+		printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+	if (check())
+		return 1;
+	printf("crc32: known vectors and random buffers ok\n");
+
+	if (argc < 2 || strcmp(argv[1], "-n"))
+		bench();
+
+	return 0;
+}
@@ -0,0 +1,25 @@
+/*
+ * Forced into every target source built on the host, so that the
+ * bootstrap's own libc-like functions do not clash with the host libc.
+ */
+#ifndef __HOST_RENAME_H__
+#define __HOST_RENAME_H__
+
+#define div		at91_div
+#define mod		at91_mod
+#define division	at91_division
+
+#define memcpy		at91_memcpy
+#define memset		at91_memset
+#define memcmp		at91_memcmp
+#define memmove		at91_memmove
+#define memchr		at91_memchr
+#define strlen		at91_strlen
+#define strcpy		at91_strcpy
+#define strcat		at91_strcat
+#define strcmp		at91_strcmp
+#define strncmp		at91_strncmp
+#define strchr		at91_strchr
+#define strstr		at91_strstr
+
+#endif /* #ifndef __HOST_RENAME_H__ */
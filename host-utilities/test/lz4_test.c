@@ -0,0 +1,480 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2017, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*
+ * Host check of the lib/lz4.c frame decoder, and estimate of the kernel
+ * load time, raw or LZ4 compressed, at a few media rates.
+ *
+ * The frames are made by a small greedy LZ4 encoder, with and without
+ * linked blocks, checksums and content size, and decoded whole and fed
+ * in random pieces as the loaders do. Output overflows, truncated frames
+ * and bad matches must be reported. A frame made by the lz4 tool may be
+ * checked too:
+ *
+ *   lz4 -9 zImage zImage.lz4
+ *   lz4_test zImage.lz4 zImage
+ *
+ * The load time is then estimated for that file, or for generated data
+ * compressing about as well as a kernel, from the host decode time:
+ * reading the frame and decoding it one after the other, as the polled
+ * loaders do, or at once when the read runs by DMA. "lz4_test -n" only
+ * runs the checks.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "lz4.h"
+
+#define DATA_SIZE	(4 << 20)
+#define FRAME_SIZE	(DATA_SIZE + DATA_SIZE / 255 + 1024)
+#define HASH_BITS	16
+#define LZ4_MAX_OFFSET	65535
+#define LZ4_MFLIMIT	12	/* no match starts in the last 12 bytes */
+#define LZ4_LASTLITERALS 5	/* and the last 5 bytes are literals */
+
+#define FLG_VERSION		0x40
+#define FLG_BLOCK_INDEPENDENT	0x20
+#define FLG_BLOCK_CHECKSUM	0x10
+#define FLG_CONTENT_SIZE	0x08
+#define FLG_CONTENT_CHECKSUM	0x04
+
+static unsigned char *data, *frame, *out;
+static int hash_pos[1 << HASH_BITS];
+
+static unsigned int rnd_state = 0x6b43a9b5;
+
+static unsigned int rnd(void)
+{
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 17;
+	rnd_state ^= rnd_state << 5;
+
+	return rnd_state;
+}
+
+static unsigned int get_le32(const unsigned char *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static unsigned char *put_le32(unsigned char *p, unsigned int val)
+{
+	p[0] = val;
+	p[1] = val >> 8;
+	p[2] = val >> 16;
+	p[3] = val >> 24;
+
+	return p + 4;
+}
+
+static unsigned char *put_length(unsigned char *op, unsigned int length)
+{
+	while (length >= 255) {
+		*op++ = 255;
+		length -= 255;
+	}
+	*op++ = length;
+
+	return op;
+}
+
+static unsigned char *put_sequence(unsigned char *op,
+				   const unsigned char *lit,
+				   unsigned int lit_len,
+				   unsigned int offset,
+				   unsigned int match_len)
+{
+	unsigned char *token = op++;
+
+	*token = (lit_len < 15 ? lit_len : 15) << 4;
+	if (lit_len >= 15)
+		op = put_length(op, lit_len - 15);
+	memcpy(op, lit, lit_len);
+	op += lit_len;
+
+	if (!match_len)
+		return op;
+
+	*op++ = offset;
+	*op++ = offset >> 8;
+	match_len -= 4;
+	*token |= match_len < 15 ? match_len : 15;
+	if (match_len >= 15)
+		op = put_length(op, match_len - 15);
+
+	return op;
+}
+
+/*
+ * Greedy LZ4 block encoder of base[start, start + len), the matches may
+ * reach back to @window.
+ */
+static unsigned int compress_block(const unsigned char *base,
+				   unsigned int start,
+				   unsigned int len,
+				   unsigned int window,
+				   unsigned char *dst)
+{
+	const unsigned char *ip = base + start;
+	const unsigned char *end = ip + len;
+	const unsigned char *anchor = ip;
+	unsigned char *op = dst;
+	unsigned int h, mlen;
+	int ref;
+
+	while ((len > LZ4_MFLIMIT) && (ip < end - LZ4_MFLIMIT)) {
+		h = (get_le32(ip) * 2654435761u) >> (32 - HASH_BITS);
+		ref = hash_pos[h];
+		hash_pos[h] = ip - base;
+
+		if ((ref < (int)window)
+		    || (ip - base - ref > LZ4_MAX_OFFSET)
+		    || (get_le32(base + ref) != get_le32(ip))) {
+			ip++;
+			continue;
+		}
+
+		mlen = 4;
+		while ((ip + mlen < end - LZ4_LASTLITERALS)
+		       && (ip[mlen] == base[ref + mlen]))
+			mlen++;
+
+		op = put_sequence(op, anchor, ip - anchor,
+				  ip - base - ref, mlen);
+		ip += mlen;
+		anchor = ip;
+	}
+
+	op = put_sequence(op, anchor, end - anchor, 0, 0);
+
+	return op - dst;
+}
+
+/* LZ4 frame of data[0, len), in blocks of 64 KB << (2 * (bsid - 4)) */
+static unsigned int compress_frame(unsigned int len,
+				   unsigned int flg,
+				   unsigned int bsid)
+{
+	unsigned int block_size = (64 * 1024) << (2 * (bsid - 4));
+	unsigned char *op = frame;
+	unsigned char *size;
+	unsigned int pos, n, csize;
+
+	op = put_le32(op, 0x184d2204);
+	*op++ = FLG_VERSION | flg;
+	*op++ = bsid << 4;
+	if (flg & FLG_CONTENT_SIZE) {
+		op = put_le32(op, len);
+		op = put_le32(op, 0);
+	}
+	*op++ = 0;	/* header checksum, not checked */
+
+	memset(hash_pos, 0xff, sizeof(hash_pos));
+	for (pos = 0; pos < len; pos += n) {
+		n = (len - pos < block_size) ? len - pos : block_size;
+		if (flg & FLG_BLOCK_INDEPENDENT)
+			memset(hash_pos, 0xff, sizeof(hash_pos));
+
+		size = op;
+		op += 4;
+		csize = compress_block(data, pos, n,
+				       (flg & FLG_BLOCK_INDEPENDENT) ? pos : 0,
+				       op);
+		if (csize >= n) {
+			memcpy(op, data + pos, n);
+			csize = n;
+			put_le32(size, n | 0x80000000);
+		} else {
+			put_le32(size, csize);
+		}
+		op += csize;
+
+		if (flg & FLG_BLOCK_CHECKSUM)
+			op = put_le32(op, 0);
+	}
+
+	op = put_le32(op, 0);
+	if (flg & FLG_CONTENT_CHECKSUM)
+		op = put_le32(op, 0);
+
+	return op - frame;
+}
+
+/*
+ * Data compressing about as well as a kernel image: runs copied from the
+ * last 32 KB mixed with literals drawn from a small alphabet.
+ */
+static void fill_data(unsigned char *buf, unsigned int len)
+{
+	unsigned int pos = 0, n, from;
+
+	while (pos < len) {
+		n = 4 + rnd() % 60;
+		if (n > len - pos)
+			n = len - pos;
+
+		if ((pos > 32 * 1024) && (rnd() % 100 < 55)) {
+			from = pos - 1 - rnd() % (32 * 1024);
+			while (n--)
+				buf[pos++] = buf[from++];
+		} else {
+			while (n--)
+				buf[pos++] = rnd() % 24;
+		}
+	}
+}
+
+/*
+ * Decode frame[0, flen) into out[0, out_size), the input being made
+ * available @piece bytes at a time (all at once if 0).
+ * Returns the decoder result once the input is exhausted.
+ */
+static int decode(unsigned int flen, unsigned int out_size,
+		  unsigned int piece, unsigned int *out_len)
+{
+	struct lz4_stream s;
+	unsigned int avail = 0;
+	int ret;
+
+	lz4_stream_init(&s, frame, out, out_size);
+	do {
+		if (piece)
+			avail += 1 + rnd() % piece;
+		if (!piece || (avail > flen))
+			avail = flen;
+		ret = lz4_stream_decode(&s, frame + avail);
+	} while (!ret && (avail < flen));
+
+	*out_len = s.out - out;
+
+	return ret;
+}
+
+static int check_frame(const char *what, unsigned int len, unsigned int flen)
+{
+	static const unsigned int pieces[] = {0, 16, 4096, 256 * 1024};
+	unsigned int i, out_len;
+	int ret;
+
+	for (i = 0; i < sizeof(pieces) / sizeof(pieces[0]); i++) {
+		memset(out, 0xa5, len + 16);
+		ret = decode(flen, len + 16, pieces[i], &out_len);
+		if ((ret != 1) || (out_len != len) || memcmp(out, data, len)) {
+			printf("%s: %u bytes, pieces of %u: decode %d, %u bytes%s\n",
+			       what, len, pieces[i], ret, out_len,
+			       (out_len == len) ? ", differs" : "");
+			return -1;
+		}
+	}
+
+	if (len && (decode(flen, len - 1, 0, &out_len) != -1)) {
+		printf("%s: %u bytes: output overflow not reported\n",
+		       what, len);
+		return -1;
+	}
+
+	/* without the end mark */
+	flen -= (frame[4] & FLG_CONTENT_CHECKSUM) ? 8 : 4;
+	if (decode(flen, len, 0, &out_len) != 0) {
+		printf("%s: %u bytes: truncated frame not reported\n",
+		       what, len);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int check_generated(void)
+{
+	static const unsigned int flgs[] = {
+		FLG_BLOCK_INDEPENDENT,
+		FLG_BLOCK_INDEPENDENT | FLG_CONTENT_SIZE | FLG_CONTENT_CHECKSUM,
+		0,
+		FLG_BLOCK_CHECKSUM | FLG_CONTENT_SIZE,
+	};
+	static const unsigned int lens[] = {
+		0, 1, 12, 13, 100, 65536, 65537, 300000, DATA_SIZE,
+	};
+	unsigned int i, j, bsid, flen;
+	char what[64];
+
+	for (i = 0; i < sizeof(flgs) / sizeof(flgs[0]); i++) {
+		for (bsid = 4; bsid <= 7; bsid++) {
+			for (j = 0; j < sizeof(lens) / sizeof(lens[0]); j++) {
+				/* incompressible, then kernel like */
+				sprintf(what, "flg %02x bd %u random",
+					FLG_VERSION | flgs[i], bsid << 4);
+				for (flen = 0; flen < lens[j]; flen++)
+					data[flen] = rnd();
+				flen = compress_frame(lens[j], flgs[i], bsid);
+				if (check_frame(what, lens[j], flen))
+					return -1;
+
+				sprintf(what, "flg %02x bd %u generated",
+					FLG_VERSION | flgs[i], bsid << 4);
+				fill_data(data, lens[j]);
+				flen = compress_frame(lens[j], flgs[i], bsid);
+				if (check_frame(what, lens[j], flen))
+					return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int check_bad(void)
+{
+	static const unsigned char bad_offset[] = {
+		0x04, 0x22, 0x4d, 0x18, 0x60, 0x40, 0x00,
+		0x04, 0x00, 0x00, 0x00,
+		0x10, 'a', 0x02, 0x00,		/* offset 2 after 1 byte */
+		0x00, 0x00, 0x00, 0x00,
+	};
+	unsigned int out_len;
+
+	memcpy(frame, bad_offset, sizeof(bad_offset));
+	if (decode(sizeof(bad_offset), 64, 0, &out_len) != -1) {
+		printf("match before the output start not reported\n");
+		return -1;
+	}
+
+	frame[13] = 0;
+	if (decode(sizeof(bad_offset), 64, 0, &out_len) != -1) {
+		printf("zero match offset not reported\n");
+		return -1;
+	}
+
+	memcpy(frame, bad_offset, sizeof(bad_offset));
+	frame[0] = 0x05;
+	if (decode(sizeof(bad_offset), 64, 0, &out_len) != -1) {
+		printf("bad frame magic not reported\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static unsigned int read_file(const char *name, unsigned char *buf,
+			      unsigned int size)
+{
+	FILE *f = fopen(name, "rb");
+	unsigned int len;
+
+	if (!f) {
+		perror(name);
+		exit(1);
+	}
+	len = fread(buf, 1, size, f);
+	if (!feof(f)) {
+		printf("%s: larger than %u bytes\n", name, size);
+		exit(1);
+	}
+	fclose(f);
+
+	return len;
+}
+
+static double now_s(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void bench(const char *what, unsigned int len, unsigned int flen)
+{
+	static const double rates[] = {2, 5, 10, 20, 40};
+	double start, dec = 1e9;
+	unsigned int i, out_len;
+
+	for (i = 0; i < 20; i++) {
+		start = now_s();
+		decode(flen, len, 0, &out_len);
+		if (now_s() - start < dec)
+			dec = now_s() - start;
+	}
+
+	printf("%s: %u bytes, lz4 %u bytes (%.0f%%), host decode %.2f ms "
+	       "(%.0f MB/s)\n", what, len, flen, 100.0 * flen / len,
+	       dec * 1e3, len / dec / (1 << 20));
+	printf("%-8s %10s %14s %14s\n", "MB/s", "raw ms", "lz4 polled ms",
+	       "lz4 DMA ms");
+	for (i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+		double raw = len / (rates[i] * (1 << 20));
+		double rd = flen / (rates[i] * (1 << 20));
+
+		printf("%-8.0f %10.1f %14.1f %14.1f\n", rates[i], raw * 1e3,
+		       (rd + dec) * 1e3, (rd > dec ? rd : dec) * 1e3);
+	}
+	printf("lz4 loads faster below %.0f MB/s, or below %.0f MB/s with a "
+	       "CPU decoding 10 times slower\n",
+	       (len - flen) / dec / (1 << 20),
+	       (len - flen) / (10 * dec) / (1 << 20));
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int len, flen;
+	int do_bench = 1;
+
+	if ((argc > 1) && !strcmp(argv[1], "-n")) {
+		do_bench = 0;
+		argc--;
+		argv++;
+	}
+
+	data = malloc(DATA_SIZE * 8);
+	frame = malloc(FRAME_SIZE * 8);
+	out = malloc(DATA_SIZE * 8 + 16);
+	if (!data || !frame || !out)
+		return 1;
+
+	if (check_generated() || check_bad())
+		return 1;
+	printf("lz4: generated frames ok\n");
+
+	if (argc > 2) {
+		flen = read_file(argv[1], frame, FRAME_SIZE * 8);
+		len = read_file(argv[2], data, DATA_SIZE * 8);
+		if (check_frame(argv[1], len, flen))
+			return 1;
+		printf("lz4: %s ok\n", argv[1]);
+		if (do_bench)
+			bench(argv[1], len, flen);
+	} else if (do_bench) {
+		fill_data(data, DATA_SIZE);
+		flen = compress_frame(DATA_SIZE, FLG_BLOCK_INDEPENDENT, 7);
+		bench("generated", DATA_SIZE, flen);
+	}
+
+	return 0;
+}
@@ -0,0 +1,340 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2017, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*
+ * PMECC random-error harness: bit errors are injected into a codeword,
+ * the remainders the PMECC would report are computed in software, and
+ * the syndrome and error locator code of driver/pmecc.c decodes them.
+ * The error locator must have exactly the injected positions as roots
+ * and match the pre-rework decoder, whose run time is reported too.
+ *
+ *   pmecc_test [seed]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "pmecc.h"
+
+#define CASES		2000
+#define BENCH_LOOPS	5
+
+extern void host_build_gf(unsigned int mm, short *index_of, short *alpha_to);
+extern void host_gen_syn(struct _PMECC_paramDesc_struct *desc, short *rem);
+extern int host_substitute(struct _PMECC_paramDesc_struct *desc);
+extern unsigned int host_get_sigma(struct _PMECC_paramDesc_struct *desc);
+extern int ref_substitute(struct _PMECC_paramDesc_struct *desc);
+extern unsigned int ref_get_sigma(struct _PMECC_paramDesc_struct *desc);
+
+struct gf {
+	int mm;
+	int nn;
+	short *alpha_to;
+	short *index_of;
+};
+
+static unsigned int rnd_state;
+
+static unsigned int rnd(void)
+{
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 17;
+	rnd_state ^= rnd_state << 5;
+
+	return rnd_state;
+}
+
+static int gf_mul(struct gf *gf, int a, int b)
+{
+	if (!a || !b)
+		return 0;
+
+	return gf->alpha_to[(gf->index_of[a] + gf->index_of[b]) % gf->nn];
+}
+
+static int check_gf(struct gf *gf)
+{
+	int i;
+
+	for (i = 0; i < gf->nn; i++) {
+		if (gf->index_of[gf->alpha_to[i]] != i) {
+			printf("GF(2^%d): index_of[alpha_to[%d]] = %d\n",
+			       gf->mm, i, gf->index_of[gf->alpha_to[i]]);
+			return -1;
+		}
+	}
+	if (gf->alpha_to[gf->nn] != 1) {
+		printf("GF(2^%d): alpha ^ nn is not 1\n", gf->mm);
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Minimal polynomial of alpha ^ i over GF(2), as a bit mask: the
+ * product of (x + beta) over the conjugates beta of alpha ^ i.
+ */
+static unsigned int min_poly(struct gf *gf, int i)
+{
+	int poly[16];
+	int deg = 0;
+	int e = i % gf->nn;
+	int k, beta;
+	unsigned int mask = 0;
+
+	poly[0] = 1;
+	do {
+		beta = gf->alpha_to[e];
+		poly[deg + 1] = 0;
+		for (k = deg + 1; k > 0; k--)
+			poly[k] = poly[k - 1] ^ gf_mul(gf, poly[k], beta);
+		poly[0] = gf_mul(gf, poly[0], beta);
+		deg++;
+		e = (2 * e) % gf->nn;
+	} while (e != i % gf->nn);
+
+	for (k = 0; k <= deg; k++) {
+		if (poly[k] & ~1)
+			return 0;
+		mask |= poly[k] << k;
+	}
+
+	return mask;
+}
+
+static unsigned int poly_deg(unsigned int poly)
+{
+	unsigned int deg = 0;
+
+	while (poly >>= 1)
+		deg++;
+
+	return deg;
+}
+
+/* x ^ pos mod m(x), for every pos of the codeword */
+static void fill_xpow(unsigned int m, unsigned int *xpow, int len)
+{
+	unsigned int deg = poly_deg(m);
+	unsigned int r = 1;
+	int pos;
+
+	for (pos = 0; pos < len; pos++) {
+		xpow[pos] = r;
+		r <<= 1;
+		if (r & (1 << deg))
+			r ^= m;
+	}
+}
+
+static int eval_sigma(struct gf *gf, short *sigma, int deg, int x)
+{
+	int k, val = 0, xk = 1;
+
+	for (k = 0; k <= deg; k++) {
+		val ^= gf_mul(gf, sigma[k], xk);
+		xk = gf_mul(gf, xk, x);
+	}
+
+	return val;
+}
+
+static int cmp_desc(struct _PMECC_paramDesc_struct *a,
+		    struct _PMECC_paramDesc_struct *b)
+{
+	int tt = a->tt;
+
+	if (memcmp(a->si, b->si, sizeof(a->si)))
+		return -1;
+	if (a->lmu[tt + 1] != b->lmu[tt + 1])
+		return -1;
+	if (memcmp(a->smu[tt + 1], b->smu[tt + 1],
+		   ((a->lmu[tt + 1] >> 1) + 1) * sizeof(short)))
+		return -1;
+
+	return 0;
+}
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static double bench(struct _PMECC_paramDesc_struct *desc,
+		    short (*rem)[TT_MAX], int ref)
+{
+	double start;
+	int loop, n;
+
+	start = now_ns();
+	for (loop = 0; loop < BENCH_LOOPS; loop++) {
+		for (n = 0; n < CASES; n++) {
+			host_gen_syn(desc, rem[n]);
+			if (ref) {
+				ref_substitute(desc);
+				ref_get_sigma(desc);
+			} else {
+				host_substitute(desc);
+				host_get_sigma(desc);
+			}
+		}
+	}
+
+	return (now_ns() - start) / (BENCH_LOOPS * CASES);
+}
+
+static int run(struct gf *gf, int sector_size, int tt)
+{
+	static struct _PMECC_paramDesc_struct desc, ref;
+	static short rem[CASES][TT_MAX];
+	static unsigned int xpow[TT_MAX][16384];
+	int len = sector_size * 8 + gf->mm * tt;
+	int pos[TT_MAX];
+	int i, j, k, n, nerr, deg, roots;
+	unsigned int m;
+
+	for (i = 0; i < tt; i++) {
+		m = min_poly(gf, 2 * i + 1);
+		if (!m) {
+			printf("no minimal polynomial for alpha ^ %d\n",
+			       2 * i + 1);
+			return -1;
+		}
+		fill_xpow(m, xpow[i], len);
+	}
+
+	memset(&desc, 0, sizeof(desc));
+	desc.tt = tt;
+	desc.mm = gf->mm;
+	desc.nn = gf->nn;
+	desc.alpha_to = gf->alpha_to;
+	desc.index_of = gf->index_of;
+	ref = desc;
+
+	for (n = 0; n < CASES; n++) {
+		nerr = rnd() % (tt + 1);
+		for (k = 0; k < nerr; k++) {
+			do {
+				pos[k] = rnd() % len;
+				for (j = 0; j < k; j++)
+					if (pos[j] == pos[k])
+						break;
+			} while (j < k);
+		}
+
+		for (i = 0; i < tt; i++) {
+			rem[n][i] = 0;
+			for (k = 0; k < nerr; k++)
+				rem[n][i] ^= xpow[i][pos[k]];
+		}
+
+		host_gen_syn(&desc, rem[n]);
+		host_substitute(&desc);
+		host_get_sigma(&desc);
+
+		host_gen_syn(&ref, rem[n]);
+		ref_substitute(&ref);
+		ref_get_sigma(&ref);
+
+		if (cmp_desc(&desc, &ref)) {
+			printf("%d B, t = %d, case %d: differs from the reference\n",
+			       sector_size, tt, n);
+			return -1;
+		}
+
+		deg = desc.lmu[tt + 1] >> 1;
+		if (deg != nerr) {
+			printf("%d B, t = %d, case %d: degree %d for %d errors\n",
+			       sector_size, tt, n, deg, nerr);
+			return -1;
+		}
+
+		/* Chien search: the roots are alpha ^ -pos */
+		roots = 0;
+		for (j = 0; j < len; j++) {
+			if (eval_sigma(gf, desc.smu[tt + 1], deg,
+				       gf->alpha_to[(gf->nn - j) % gf->nn]))
+				continue;
+			for (k = 0; k < nerr; k++)
+				if (pos[k] == j)
+					break;
+			if (k == nerr) {
+				printf("%d B, t = %d, case %d: bad root %d\n",
+				       sector_size, tt, n, j);
+				return -1;
+			}
+			roots++;
+		}
+		if (roots != nerr) {
+			printf("%d B, t = %d, case %d: %d roots for %d errors\n",
+			       sector_size, tt, n, roots, nerr);
+			return -1;
+		}
+	}
+
+	printf("%4d B, t = %2d: %d cases ok, decode %7.0f ns, reference %7.0f ns\n",
+	       sector_size, tt, CASES,
+	       bench(&desc, rem, 0), bench(&ref, rem, 1));
+
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	static const int tts[] = {2, 4, 8, 12, 24};
+	static short index_of[2][1 << 14], alpha_to[2][1 << 14];
+	struct gf gf;
+	int i, s;
+
+	rnd_state = (argc > 1) ? strtoul(argv[1], NULL, 0) : 0x1234567;
+	if (!rnd_state)
+		rnd_state = 1;
+
+	for (s = 0; s < 2; s++) {
+		gf.mm = 13 + s;
+		gf.nn = (1 << gf.mm) - 1;
+		gf.index_of = index_of[s];
+		gf.alpha_to = alpha_to[s];
+		host_build_gf(gf.mm, gf.index_of, gf.alpha_to);
+		if (check_gf(&gf))
+			return 1;
+
+		for (i = 0; i < sizeof(tts) / sizeof(tts[0]); i++)
+			if (run(&gf, 512 << s, tts[i]))
+				return 1;
+	}
+
+	printf("PMECC: all cases ok\n");
+
+	return 0;
+}
@@ -0,0 +1,71 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2017, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*
+ * The byte loops lib/string.c had before the word and burst copies,
+ * kept as the baseline of the string benchmark.
+ */
+void *ref_memcpy(void *dst, const void *src, int cnt)
+{
+	char *d = (char *)dst;
+	const char *s = (const char *)src;
+
+	while (cnt--)
+		*d++ = *s++;
+
+	return d;
+}
+
+void *ref_memset(void *dst, int val, int cnt)
+{
+	char *d = (char *)dst;
+
+	while (cnt--)
+		*d++ = (char)val;
+
+	return d;
+}
+
+void *ref_memmove(void *dst, const void *src, unsigned int cnt)
+{
+	char *p, *s;
+
+	if (dst <= src) {
+		p = (char *)dst;
+		s = (char *)src;
+		while (cnt--)
+			*p++ = *s++;
+		}
+	else {
+		p = (char *)dst + cnt;
+		s = (char *)src + cnt;
+		while (cnt--)
+			*--p = *--s;
+		}
+
+	return dst;
+}
@@ -0,0 +1,264 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2017, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*
+ * Host check and benchmark of memcpy(), memset() and memmove() from
+ * lib/string.c: every length up to a few bursts at every source and
+ * destination alignment, overlapping moves both ways, and guard bytes
+ * around the destination, all compared to the host libc. The copy
+ * rates of lib/string.c, of its former byte loops and of the host libc
+ * are then printed for a few buffer sizes.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+extern void *at91_memcpy(void *dst, const void *src, int cnt);
+extern void *at91_memset(void *dst, int val, int cnt);
+extern void *at91_memmove(void *dst, const void *src, unsigned int cnt);
+extern void *ref_memcpy(void *dst, const void *src, int cnt);
+extern void *ref_memset(void *dst, int val, int cnt);
+extern void *ref_memmove(void *dst, const void *src, unsigned int cnt);
+
+#define ALIGN		8
+#define GUARD		16
+#define CHECK_MAX	(3 * 32 + 2 * ALIGN)
+#define CHECK_LENS	{1000, 4093, 4096, 65536 + 3}
+#define BUF_SIZE	(96 * 1024)
+#define BENCH_BYTES	(256 << 20)
+
+static unsigned char src[BUF_SIZE + 2 * ALIGN];
+static unsigned char dst[BUF_SIZE + 2 * ALIGN + 2 * GUARD];
+static unsigned char want[BUF_SIZE + 2 * ALIGN + 2 * GUARD];
+static unsigned char noise[BUF_SIZE + 2 * ALIGN + 2 * GUARD];
+
+static void fill_random(unsigned char *buf, unsigned int len)
+{
+	static unsigned int seed = 0x2545f491;
+
+	while (len--) {
+		seed = seed * 1103515245 + 12345;
+		*buf++ = seed >> 16;
+	}
+}
+
+static int check_copy(int len, int soff, int doff)
+{
+	memcpy(dst, noise, sizeof(dst));
+	memcpy(want, noise, sizeof(want));
+
+	if (at91_memcpy(dst + GUARD + doff, src + soff, len)
+	    != dst + GUARD + doff) {
+		printf("memcpy: bad return value\n");
+		return -1;
+	}
+	memcpy(want + GUARD + doff, src + soff, len);
+	if (memcmp(dst, want, sizeof(dst))) {
+		printf("memcpy: len %d src +%d dst +%d differs\n",
+		       len, soff, doff);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int check_set(int len, int doff, int val)
+{
+	memcpy(dst, noise, sizeof(dst));
+	memcpy(want, noise, sizeof(want));
+
+	if (at91_memset(dst + GUARD + doff, val, len) != dst + GUARD + doff) {
+		printf("memset: bad return value\n");
+		return -1;
+	}
+	memset(want + GUARD + doff, val, len);
+	if (memcmp(dst, want, sizeof(dst))) {
+		printf("memset: len %d dst +%d val %#x differs\n",
+		       len, doff, val);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Overlapping moves in the middle of dst, the source @shift bytes away */
+static int check_move(int len, int off, int shift)
+{
+	unsigned char *buf = dst + (((sizeof(dst) - len) / 2) & ~(ALIGN - 1));
+
+	memcpy(dst, noise, sizeof(dst));
+	memcpy(want, noise, sizeof(want));
+
+	if (at91_memmove(buf + off, buf + off + shift, len) != buf + off) {
+		printf("memmove: bad return value\n");
+		return -1;
+	}
+	memmove(want + (buf - dst) + off, want + (buf - dst) + off + shift, len);
+	if (memcmp(dst, want, sizeof(dst))) {
+		printf("memmove: len %d dst +%d src %+d differs\n",
+		       len, off, shift);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int check(void)
+{
+	static const int lens[] = CHECK_LENS;
+	int len, i, soff, doff, shift;
+
+	fill_random(src, sizeof(src));
+	fill_random(noise, sizeof(noise));
+
+	for (len = 0; len <= CHECK_MAX; len++)
+		for (soff = 0; soff < ALIGN; soff++)
+			for (doff = 0; doff < ALIGN; doff++)
+				if (check_copy(len, soff, doff))
+					return -1;
+	for (i = 0; i < sizeof(lens) / sizeof(lens[0]); i++)
+		for (soff = 0; soff < ALIGN; soff++)
+			for (doff = 0; doff < ALIGN; doff++)
+				if (check_copy(lens[i], soff, doff))
+					return -1;
+
+	for (len = 0; len <= CHECK_MAX; len++)
+		for (doff = 0; doff < ALIGN; doff++)
+			if (check_set(len, doff, 0)
+			    || check_set(len, doff, 0x1a5))
+				return -1;
+	for (i = 0; i < sizeof(lens) / sizeof(lens[0]); i++)
+		for (doff = 0; doff < ALIGN; doff++)
+			if (check_set(lens[i], doff, 0xff))
+				return -1;
+
+	for (len = 0; len <= CHECK_MAX; len++)
+		for (doff = 0; doff < ALIGN; doff++)
+			for (shift = -2 * ALIGN; shift <= 2 * ALIGN; shift++)
+				if (check_move(len, doff, shift))
+					return -1;
+	for (i = 0; i < sizeof(lens) / sizeof(lens[0]); i++)
+		for (shift = -ALIGN; shift <= ALIGN; shift++)
+			if (check_move(lens[i], 0, shift)
+			    || check_move(lens[i], 0, shift * 1024))
+				return -1;
+
+	return 0;
+}
+
+static double now_s(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+enum {
+	FN_MEMCPY,
+	FN_MEMSET,
+	FN_MEMMOVE,
+};
+
+static double rate(int fn, int impl, int len, int soff)
+{
+	unsigned int loops = BENCH_BYTES / len;
+	unsigned int i;
+	double start;
+
+	start = now_s();
+	for (i = 0; i < loops; i++) {
+		switch (fn) {
+		case FN_MEMCPY:
+			if (impl == 0)
+				at91_memcpy(dst, src + soff, len);
+			else if (impl == 1)
+				ref_memcpy(dst, src + soff, len);
+			else
+				memcpy(dst, src + soff, len);
+			break;
+		case FN_MEMSET:
+			if (impl == 0)
+				at91_memset(dst, i, len);
+			else if (impl == 1)
+				ref_memset(dst, i, len);
+			else
+				memset(dst, i, len);
+			break;
+		default:
+			/* backward overlapping move */
+			if (impl == 0)
+				at91_memmove(dst + 64, dst, len);
+			else if (impl == 1)
+				ref_memmove(dst + 64, dst, len);
+			else
+				memmove(dst + 64, dst, len);
+			break;
+		}
+		/* keep the compiler from dropping the libc calls */
+		asm volatile("" : : "r" (dst) : "memory");
+	}
+
+	return (double)loops * len / (now_s() - start) / (1 << 20);
+}
+
+static void bench(void)
+{
+	static const int lens[] = {64, 1024, 64 * 1024};
+	static const char *const names[] = {
+		"memcpy", "memcpy (src + 1)", "memset", "memmove (overlap)",
+	};
+	int i, t;
+
+	printf("%-20s %8s %12s %12s %12s\n", "MB/s", "bytes",
+	       "lib/string.c", "byte loop", "host libc");
+	for (t = 0; t < 4; t++) {
+		int fn = t < 2 ? FN_MEMCPY : t - 1;
+		int soff = t == 1;
+
+		for (i = 0; i < sizeof(lens) / sizeof(lens[0]); i++)
+			printf("%-20s %8d %12.0f %12.0f %12.0f\n",
+			       names[t], lens[i],
+			       rate(fn, 0, lens[i], soff),
+			       rate(fn, 1, lens[i], soff),
+			       rate(fn, 2, lens[i], soff));
+	}
+}
+
+int main(int argc, char **argv)
+{
+	if (check())
+		return 1;
+	printf("string: memcpy, memset and memmove match the host libc\n");
+
+	if (argc < 2 || strcmp(argv[1], "-n"))
+		bench();
+
+	return 0;
+}
@@ -34,6 +34,9 @@
 #define AT91_AES_IV_SIZE_BYTE		16
 #define AT91_AES_IV_SIZE_WORD		4
 
+#define AT91_AES_GCM_IV_SIZE_BYTE	12
+#define AT91_AES_GCM_IV_SIZE_WORD	3
+
 typedef enum at91_aes_operation {
 	AT91_AES_OP_DECRYPT,
 	AT91_AES_OP_ENCRYPT,
@@ -106,4 +109,40 @@ int at91_aes_cmac(unsigned int data_length,
 		  at91_aes_key_size_t key_size,
 		  const unsigned int *key);
 
+int at91_aes_cmac_update(unsigned int data_length,
+			 const void *data,
+			 unsigned int *cmac,
+			 at91_aes_key_size_t key_size,
+			 const unsigned int *key);
+
+int at91_aes_cmac_final(const void *last_block,
+			unsigned int *cmac,
+			at91_aes_key_size_t key_size,
+			const unsigned int *key);
+
+#ifdef CPU_HAS_AES_GCM
+int at91_aes_gcm_start(at91_aes_key_size_t key_size,
+		       const unsigned int *key,
+		       const unsigned int *iv,
+		       const void *aad,
+		       unsigned int aad_length,
+		       unsigned int data_length);
+
+int at91_aes_gcm_update(unsigned int data_length,
+			const void *input,
+			void *output);
+
+int at91_aes_gcm_final(unsigned int *tag);
+
+int at91_aes_gcm(unsigned int data_length,
+		 const void *input,
+		 void *output,
+		 at91_aes_key_size_t key_size,
+		 const unsigned int *key,
+		 const unsigned int *iv,
+		 const void *aad,
+		 unsigned int aad_length,
+		 unsigned int *tag);
+#endif
+
 #endif /* __AES_H__ */
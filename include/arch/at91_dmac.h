@@ -0,0 +1,112 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2017, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __AT91_DMAC_H__
+#define __AT91_DMAC_H__
+
+/**** Register offset in AT91_DMAC structure ***/
+#define DMAC_GCFG	0x00	/* Global Configuration Register */
+#define DMAC_EN		0x04	/* Enable Register */
+#define DMAC_SREQ	0x08	/* Software Single Request Register */
+#define DMAC_CREQ	0x0C	/* Software Chunk Transfer Request Register */
+#define DMAC_LAST	0x10	/* Software Last Transfer Flag Register */
+#define DMAC_EBCIER	0x18	/* Buffer Transfer Completed Interrupt Enable */
+#define DMAC_EBCIDR	0x1C	/* Buffer Transfer Completed Interrupt Disable */
+#define DMAC_EBCIMR	0x20	/* Buffer Transfer Completed Interrupt Mask */
+#define DMAC_EBCISR	0x24	/* Buffer Transfer Completed Interrupt Status */
+#define DMAC_CHER	0x28	/* Channel Handler Enable Register */
+#define DMAC_CHDR	0x2C	/* Channel Handler Disable Register */
+#define DMAC_CHSR	0x30	/* Channel Handler Status Register */
+
+/* Channel registers, offset from DMAC_CH(n) */
+#define DMAC_CH(n)	(0x3C + ((n) * 0x28))
+#define DMAC_SADDR	0x00	/* Channel Source Address Register */
+#define DMAC_DADDR	0x04	/* Channel Destination Address Register */
+#define DMAC_DSCR	0x08	/* Channel Descriptor Address Register */
+#define DMAC_CTRLA	0x0C	/* Channel Control A Register */
+#define DMAC_CTRLB	0x10	/* Channel Control B Register */
+#define DMAC_CFG	0x14	/* Channel Configuration Register */
+#define DMAC_SPIP	0x18	/* Channel Source Picture-in-Picture */
+#define DMAC_DPIP	0x1C	/* Channel Destination Picture-in-Picture */
+
+/*-------- DMAC_EN : Enable Register --------*/
+#define DMAC_EN_ENABLE		(0x1UL << 0)
+
+/*-------- DMAC_EBCISR : Interrupt Status Register --------*/
+#define DMAC_EBCISR_BTC(n)	(0x1UL << (n))		/* Buffer Transfer Completed */
+#define DMAC_EBCISR_CBTC(n)	(0x1UL << ((n) + 8))	/* Chained Buffer Completed */
+#define DMAC_EBCISR_ERR(n)	(0x1UL << ((n) + 16))	/* Access Error */
+
+/*-------- DMAC_CHER / DMAC_CHDR / DMAC_CHSR --------*/
+#define DMAC_CHSR_ENA(n)	(0x1UL << (n))		/* Channel Enabled */
+
+/*-------- DMAC_DSCR : Descriptor Address Register --------*/
+#define DMAC_DSCR_IF(n)		((n) & 0x3UL)		/* Descriptor Interface */
+
+/*-------- DMAC_CTRLA : Control A Register --------*/
+#define DMAC_CTRLA_BTSIZE_MAX		0xFFFFUL	/* in source data units */
+#define DMAC_CTRLA_SCSIZE_CHK_1		(0x0UL << 16)	/* Source Chunk Size */
+#define DMAC_CTRLA_SCSIZE_CHK_4		(0x1UL << 16)
+#define DMAC_CTRLA_SCSIZE_CHK_8		(0x2UL << 16)
+#define DMAC_CTRLA_SCSIZE_CHK_16	(0x3UL << 16)
+#define DMAC_CTRLA_DCSIZE_CHK_1		(0x0UL << 20)	/* Destination Chunk Size */
+#define DMAC_CTRLA_DCSIZE_CHK_4		(0x1UL << 20)
+#define DMAC_CTRLA_DCSIZE_CHK_8		(0x2UL << 20)
+#define DMAC_CTRLA_DCSIZE_CHK_16	(0x3UL << 20)
+#define DMAC_CTRLA_SRC_WIDTH(n)		(((n) & 0x3UL) << 24)	/* Source Width */
+#define DMAC_CTRLA_DST_WIDTH(n)		(((n) & 0x3UL) << 28)	/* Destination Width */
+#define DMAC_CTRLA_DONE			(0x1UL << 31)
+
+/*-------- DMAC_CTRLB : Control B Register --------*/
+#define DMAC_CTRLB_SIF(n)		(((n) & 0x3UL) << 0)	/* Source Interface */
+#define DMAC_CTRLB_DIF(n)		(((n) & 0x3UL) << 4)	/* Destination Interface */
+#define DMAC_CTRLB_SRC_DSCR_FETCH_DISABLE	(0x1UL << 16)
+#define DMAC_CTRLB_DST_DSCR_FETCH_DISABLE	(0x1UL << 20)
+#define DMAC_CTRLB_FC_MEM2MEM		(0x0UL << 21)	/* Flow Controller */
+#define DMAC_CTRLB_FC_MEM2PER		(0x1UL << 21)
+#define DMAC_CTRLB_FC_PER2MEM		(0x2UL << 21)
+#define DMAC_CTRLB_FC_PER2PER		(0x3UL << 21)
+#define DMAC_CTRLB_SRC_INCR_INCREMENTING	(0x0UL << 24)
+#define DMAC_CTRLB_SRC_INCR_FIXED		(0x2UL << 24)
+#define DMAC_CTRLB_DST_INCR_INCREMENTING	(0x0UL << 28)
+#define DMAC_CTRLB_DST_INCR_FIXED		(0x2UL << 28)
+#define DMAC_CTRLB_IEN			(0x1UL << 30)	/* Interrupt Enable (active low) */
+#define DMAC_CTRLB_AUTO			(0x1UL << 31)	/* Automatic Multiple Buffer */
+
+/*-------- DMAC_CFG : Channel Configuration Register --------*/
+#define DMAC_CFG_SRC_PER(n)		((n) & 0xFUL)		/* Source Handshake ID */
+#define DMAC_CFG_DST_PER(n)		(((n) & 0xFUL) << 4)	/* Destination Handshake ID */
+#define DMAC_CFG_SRC_H2SEL_HW		(0x1UL << 9)		/* Hardware Handshake */
+#define DMAC_CFG_SRC_PER_MSB(n)		((((n) >> 4) & 0x3UL) << 10)
+#define DMAC_CFG_DST_H2SEL_HW		(0x1UL << 13)
+#define DMAC_CFG_DST_PER_MSB(n)		((((n) >> 4) & 0x3UL) << 14)
+#define DMAC_CFG_SOD			(0x1UL << 16)		/* Stop On Done */
+#define DMAC_CFG_FIFOCFG_ALAP		(0x0UL << 28)		/* FIFO Configuration */
+#define DMAC_CFG_FIFOCFG_HALF		(0x1UL << 28)
+#define DMAC_CFG_FIFOCFG_ASAP		(0x2UL << 28)
+
+#endif /* #ifndef __AT91_DMAC_H__ */
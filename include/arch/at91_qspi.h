@@ -83,6 +83,7 @@
 #define		QSPI_MR_NBBITS_16_BIT		(0x8 << 8)
 #define	QSPI_MR_DLYBCT		(0xff << 16)	/* Delay Between Consecutive Transfers */
 #define	QSPI_MR_DLYCS		(0xff << 24)	/* Minimum Inactive QCS Delay */
+#define	QSPI_MR_DLYCS_(x)	(((x) << 24) & QSPI_MR_DLYCS)
 
 /* QSPI_SR */
 #define	QSPI_SR_RDRF		(0x1 << 0)	/* Receive Data Register Full */
@@ -99,7 +100,8 @@
 #define	QSPI_SCR_CPHA		(0x1 << 1)	/* Clock Phase */
 #define	QSPI_SCR_SCBR		(0xff << 8)
 #define	QSPI_SCR_SCBR_(x)	(((x) << 8) & QSPI_SCR_SCBR)	/* Serial Clock Baud Rate */
-#define	QSPI_SCR_DLYBS_(x)	((x) << 16)	/* Delay Before QSCK */
+#define	QSPI_SCR_DLYBS		(0xff << 16)
+#define	QSPI_SCR_DLYBS_(x)	(((x) << 16) & QSPI_SCR_DLYBS)	/* Delay Before QSCK */
 
 /* QSPI_ICR */
 #define	QSPI_ICR_INST_(x)	((x) << 0)	/* Instruction Code */
@@ -38,12 +38,29 @@
 #define SPI_IDR		0x18	/* Interrupt Disable Register */
 #define SPI_IMR		0x1C	/* Interrupt Mask Register */
 #define SPI_CSR(x)	(0x30 + 4 * (x))	/* Chip Select Register */
+#define SPI_FMR		0x40	/* FIFO Mode Register */
+#define SPI_FLR		0x44	/* FIFO Level Register */
+
+/* *** PDC registers, on the SPI controllers that have them ***/
+#define SPI_RPR		0x100	/* Receive Pointer Register */
+#define SPI_RCR		0x104	/* Receive Counter Register */
+#define SPI_TPR		0x108	/* Transmit Pointer Register */
+#define SPI_TCR		0x10C	/* Transmit Counter Register */
+#define SPI_RNPR	0x110	/* Receive Next Pointer Register */
+#define SPI_RNCR	0x114	/* Receive Next Counter Register */
+#define SPI_TNPR	0x118	/* Transmit Next Pointer Register */
+#define SPI_TNCR	0x11C	/* Transmit Next Counter Register */
+#define SPI_PTCR	0x120	/* PDC Transfer Control Register */
 
 /* -------- SPI_CR : (SPI Offset: 0x0) SPI Control Register --------*/ 
 #define AT91C_SPI_SPIEN		(0x1UL <<  0)
 #define AT91C_SPI_SPIDIS	(0x1UL <<  1)
 #define AT91C_SPI_SWRST		(0x1UL <<  7)
+#define AT91C_SPI_TXFCLR	(0x1UL << 16)
+#define AT91C_SPI_RXFCLR	(0x1UL << 17)
 #define AT91C_SPI_LASTXFER	(0x1UL << 24)
+#define AT91C_SPI_FIFOEN	(0x1UL << 30)
+#define AT91C_SPI_FIFODIS	(0x1UL << 31)
 
 /* -------- SPI_MR : (SPI Offset: 0x4) SPI Mode Register --------*/ 
 #define AT91C_SPI_MSTR		(0x1UL <<  0)
@@ -101,4 +118,15 @@
 #define AT91C_SPI_DLYBS(x)	(x << 16)
 #define AT91C_SPI_DLYBCT(x)	(x << 24)
 
+/* -------- SPI_FLR : (SPI Offset: 0x44) FIFO Level Register -------- */
+#define AT91C_SPI_TXFL		(0x3FUL << 0)
+#define AT91C_SPI_RXFL		(0x3FUL << 16)
+#define AT91C_SPI_RXFL_(x)	(((x) & AT91C_SPI_RXFL) >> 16)
+
+/* -------- SPI_PTCR : (SPI Offset: 0x120) PDC Transfer Control Register -------- */
+#define AT91C_PDC_RXTEN		(0x1UL << 0)
+#define AT91C_PDC_RXTDIS	(0x1UL << 1)
+#define AT91C_PDC_TXTEN		(0x1UL << 8)
+#define AT91C_PDC_TXTDIS	(0x1UL << 9)
+
 #endif /* #ifndef __AT91_SPI_H__ */
@@ -0,0 +1,131 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2017, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __AT91_XDMAC_H__
+#define __AT91_XDMAC_H__
+
+/**** Register offset in AT91_XDMAC structure ***/
+#define XDMAC_GTYPE	0x00	/* Global Type Register */
+#define XDMAC_GCFG	0x04	/* Global Configuration Register */
+#define XDMAC_GWAC	0x08	/* Global Weighted Arbiter Configuration Register */
+#define XDMAC_GIE	0x0C	/* Global Interrupt Enable Register */
+#define XDMAC_GID	0x10	/* Global Interrupt Disable Register */
+#define XDMAC_GIM	0x14	/* Global Interrupt Mask Register */
+#define XDMAC_GIS	0x18	/* Global Interrupt Status Register */
+#define XDMAC_GE	0x1C	/* Global Channel Enable Register */
+#define XDMAC_GD	0x20	/* Global Channel Disable Register */
+#define XDMAC_GS	0x24	/* Global Channel Status Register */
+#define XDMAC_GRS	0x28	/* Global Channel Read Suspend Register */
+#define XDMAC_GWS	0x2C	/* Global Channel Write Suspend Register */
+#define XDMAC_GRWS	0x30	/* Global Channel Read Write Suspend Register */
+#define XDMAC_GRWR	0x34	/* Global Channel Read Write Resume Register */
+#define XDMAC_GSWR	0x38	/* Global Channel Software Request Register */
+#define XDMAC_GSWS	0x3C	/* Global Channel Software Request Status Register */
+#define XDMAC_GSWF	0x40	/* Global Channel Software Flush Request Register */
+
+/* Channel registers, offset from XDMAC_CH(n) */
+#define XDMAC_CH(n)	(0x50 + ((n) * 0x40))
+#define XDMAC_CIE	0x00	/* Channel Interrupt Enable Register */
+#define XDMAC_CID	0x04	/* Channel Interrupt Disable Register */
+#define XDMAC_CIM	0x08	/* Channel Interrupt Mask Register */
+#define XDMAC_CIS	0x0C	/* Channel Interrupt Status Register */
+#define XDMAC_CSA	0x10	/* Channel Source Address Register */
+#define XDMAC_CDA	0x14	/* Channel Destination Address Register */
+#define XDMAC_CNDA	0x18	/* Channel Next Descriptor Address Register */
+#define XDMAC_CNDC	0x1C	/* Channel Next Descriptor Control Register */
+#define XDMAC_CUBC	0x20	/* Channel Microblock Control Register */
+#define XDMAC_CBC	0x24	/* Channel Block Control Register */
+#define XDMAC_CC	0x28	/* Channel Configuration Register */
+#define XDMAC_CDS_MSP	0x2C	/* Channel Data Stride Memory Set Pattern */
+#define XDMAC_CSUS	0x30	/* Channel Source Microblock Stride */
+#define XDMAC_CDUS	0x34	/* Channel Destination Microblock Stride */
+
+/*-------- XDMAC_CIS : Channel Interrupt Status Register --------*/
+#define XDMAC_CIS_BIS		(0x1UL << 0)	/* End of Block */
+#define XDMAC_CIS_LIS		(0x1UL << 1)	/* End of Linked List */
+#define XDMAC_CIS_DIS		(0x1UL << 2)	/* End of Disable */
+#define XDMAC_CIS_FIS		(0x1UL << 3)	/* End of Flush */
+#define XDMAC_CIS_RBEIS		(0x1UL << 4)	/* Read Bus Error */
+#define XDMAC_CIS_WBEIS		(0x1UL << 5)	/* Write Bus Error */
+#define XDMAC_CIS_ROIS		(0x1UL << 6)	/* Request Overflow Error */
+#define XDMAC_CIS_ERRORS	(XDMAC_CIS_RBEIS | XDMAC_CIS_WBEIS | XDMAC_CIS_ROIS)
+
+/*-------- XDMAC_CNDA : Channel Next Descriptor Address Register --------*/
+#define XDMAC_CNDA_NDAIF(n)	((n) & 0x1UL)	/* Descriptor Interface */
+
+/*-------- XDMAC_CNDC : Channel Next Descriptor Control Register --------*/
+#define XDMAC_CNDC_NDE		(0x1UL << 0)	/* Descriptor Fetch Enable */
+#define XDMAC_CNDC_NDSUP	(0x1UL << 1)	/* Source Parameters Updated */
+#define XDMAC_CNDC_NDDUP	(0x1UL << 2)	/* Destination Parameters Updated */
+#define XDMAC_CNDC_NDVIEW_NDV0	(0x0UL << 3)	/* Descriptor View 0 */
+#define XDMAC_CNDC_NDVIEW_NDV1	(0x1UL << 3)	/* Descriptor View 1 */
+#define XDMAC_CNDC_NDVIEW_NDV2	(0x2UL << 3)	/* Descriptor View 2 */
+#define XDMAC_CNDC_NDVIEW_NDV3	(0x3UL << 3)	/* Descriptor View 3 */
+
+/*-------- XDMAC_CUBC : Channel Microblock Control Register --------*/
+#define XDMAC_CUBC_UBLEN_MAX	0xFFFFFFUL	/* in data units */
+
+/*-------- XDMAC_CC : Channel Configuration Register --------*/
+#define XDMAC_CC_TYPE_MEM_TRAN		(0x0UL << 0)	/* Memory to Memory */
+#define XDMAC_CC_TYPE_PER_TRAN		(0x1UL << 0)	/* Peripheral Synchronized */
+#define XDMAC_CC_MBSIZE_SINGLE		(0x0UL << 1)	/* Memory Burst Size */
+#define XDMAC_CC_MBSIZE_FOUR		(0x1UL << 1)
+#define XDMAC_CC_MBSIZE_EIGHT		(0x2UL << 1)
+#define XDMAC_CC_MBSIZE_SIXTEEN		(0x3UL << 1)
+#define XDMAC_CC_DSYNC_PER2MEM		(0x0UL << 4)	/* Synchronization */
+#define XDMAC_CC_DSYNC_MEM2PER		(0x1UL << 4)
+#define XDMAC_CC_PROT_SEC		(0x0UL << 5)	/* Channel Protection */
+#define XDMAC_CC_PROT_UNSEC		(0x1UL << 5)
+#define XDMAC_CC_SWREQ_HWR_CONNECTED	(0x0UL << 6)	/* Request Type */
+#define XDMAC_CC_SWREQ_SWR_CONNECTED	(0x1UL << 6)
+#define XDMAC_CC_MEMSET_NORMAL_MODE	(0x0UL << 7)	/* Fill Zero Memory */
+#define XDMAC_CC_MEMSET_HW_MODE		(0x1UL << 7)
+#define XDMAC_CC_CSIZE_CHK_1		(0x0UL << 8)	/* Chunk Size */
+#define XDMAC_CC_CSIZE_CHK_2		(0x1UL << 8)
+#define XDMAC_CC_CSIZE_CHK_4		(0x2UL << 8)
+#define XDMAC_CC_CSIZE_CHK_8		(0x3UL << 8)
+#define XDMAC_CC_CSIZE_CHK_16		(0x4UL << 8)
+#define XDMAC_CC_DWIDTH(n)		(((n) & 0x3UL) << 11)	/* Data Width */
+#define XDMAC_CC_SIF(n)			(((n) & 0x1UL) << 13)	/* Source Interface */
+#define XDMAC_CC_DIF(n)			(((n) & 0x1UL) << 14)	/* Destination Interface */
+#define XDMAC_CC_SAM_FIXED_AM		(0x0UL << 16)	/* Source Addressing Mode */
+#define XDMAC_CC_SAM_INCREMENTED_AM	(0x1UL << 16)
+#define XDMAC_CC_DAM_FIXED_AM		(0x0UL << 18)	/* Destination Addressing Mode */
+#define XDMAC_CC_DAM_INCREMENTED_AM	(0x1UL << 18)
+#define XDMAC_CC_INITD			(0x1UL << 21)	/* Channel Initialization Terminated */
+#define XDMAC_CC_RDIP			(0x1UL << 22)	/* Read in Progress */
+#define XDMAC_CC_WRIP			(0x1UL << 23)	/* Write in Progress */
+#define XDMAC_CC_PERID(n)		(((n) & 0x7FUL) << 24)	/* Peripheral Hardware Request ID */
+
+/*-------- Linked list descriptor, view 1: Microblock Control Member --------*/
+#define XDMAC_MBR_UBC_UBLEN(n)		((n) & XDMAC_CUBC_UBLEN_MAX)
+#define XDMAC_MBR_UBC_NDE		(0x1UL << 24)	/* Next Descriptor Enable */
+#define XDMAC_MBR_UBC_NSEN		(0x1UL << 25)	/* Next Source Update */
+#define XDMAC_MBR_UBC_NDEN		(0x1UL << 26)	/* Next Destination Update */
+#define XDMAC_MBR_UBC_NVIEW_NDV1	(0x1UL << 27)	/* Next Descriptor View 1 */
+
+#endif /* #ifndef __AT91_XDMAC_H__ */
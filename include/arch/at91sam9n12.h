@@ -136,6 +136,14 @@
 
 #define AT91C_NUM_PIO		4
 
+/*
+ * DMAC hardware requests
+ */
+#define AT91C_DMA_PERID_SPI0_TX	1
+#define AT91C_DMA_PERID_SPI0_RX	2
+#define AT91C_DMA_PERID_SPI1_TX	3
+#define AT91C_DMA_PERID_SPI1_RX	4
+
 /*
  * SoC specific defines
  */
@@ -141,6 +141,12 @@
 
 #define AT91C_NUM_PIO		4
 
+/*
+ * DMAC0 hardware requests, SPI1 is only served by DMAC1
+ */
+#define AT91C_DMA_PERID_SPI0_TX	1
+#define AT91C_DMA_PERID_SPI0_RX	2
+
 /*
  * SoC specific defines
  */
@@ -61,6 +61,20 @@
 #define L2CC_PCR	0xF60	/* Prefetch Control Register */
 #define L2CC_POWCR	0xF80	/* Power Control Register */
 
+/*-------- L2CC_IDR : (L2CC Offset: 0x00) Cache ID Register --------*/
+#define L2CC_IDR_RTL_MASK	(0x3f << 0)	/* RTL Release */
+#define L2CC_IDR_RTL_R3P0	(0x05 << 0)
+#define L2CC_IDR_RTL_R3P1	(0x06 << 0)
+
+/*-------- L2CC_CR : (L2CC Offset: 0x100) Control Register --------*/
+#define L2CC_CR_L2CEN		(0x01 << 0)	/* L2 Cache Enable */
+
+/*-------- L2CC_ACR : (L2CC Offset: 0x104) Auxiliary Control Register --------*/
+#define L2CC_ACR_EBRESPE	(0x01 << 30)	/* Early BRESP Enable */
+
+/*-------- L2CC_CSR : (L2CC Offset: 0x730) Cache Synchronization Register --------*/
+#define L2CC_CSR_C		(0x01 << 0)	/* Cache Synchronization Status */
+
 /*-------- L2CC_PCR : (L2CC Offset: 0xF60) Prefetch Control Register --------*/
 #define L2CC_PCR_OFFSET(value)	(((value) & 0x1f) << 0)	/* Prefetch Offset */
 #define L2CC_PCR_NSIDEN		(0x01 << 21)	/* Incr Double Linefill Enable */
@@ -147,6 +147,7 @@
 #define	AT91C_BASE_SAIC		0xf803c000
 #define	AT91C_BASE_ICM		0xf8040000
 #define	AT91C_BASE_SECURAM	0xf8044000
+#define	AT91C_BASE_BUREG	0xf8045400	/* Backup registers */
 #define	AT91C_BASE_SYSC		0xf8048000
 #define	AT91C_BASE_ACC		0xf804a000
 #define	AT91C_BASE_SFC		0xf804c000
@@ -263,6 +263,14 @@
 #define	H32MX_USB			5
 #define	H32MX_SMD			6	/* Soft Modem(SMD) */
 
+/*
+ * XDMAC hardware requests
+ */
+#define AT91C_DMA_PERID_SPI0_TX	10
+#define AT91C_DMA_PERID_SPI0_RX	11
+#define AT91C_DMA_PERID_SPI1_TX	12
+#define AT91C_DMA_PERID_SPI1_RX	13
+
 /*
  * SoC specific defines
  */
@@ -80,6 +80,16 @@ extern void load_image_done(int retval);
 extern int load_kernel(struct image_info *image);
 
 extern int kernel_size(unsigned char *addr);
+extern unsigned char *kernel_image_dest(struct image_info *image);
+
+#if defined(CONFIG_KERNEL_LZ4) || defined(CONFIG_KERNEL_CRC)
+extern void kernel_stream_start(void *data);
+extern void kernel_stream_update(const void *data, unsigned int length);
+#else
+static inline void kernel_stream_start(void *data) {}
+static inline void kernel_stream_update(const void *data,
+					unsigned int length) {}
+#endif
 
 static inline unsigned int swap_uint32(unsigned int data)
 {
@@ -63,4 +63,7 @@ extern int lpddr1_sdram_initialize(unsigned int base_address,
 
 extern void ddramc_dump_regs(unsigned int base_address);
 
+/* The size of the DDR bank, as detected or else as configured */
+extern unsigned int ddram_get_size(void);
+
 #endif /* #ifndef __DDRAMC_H__ */
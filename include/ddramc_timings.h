@@ -0,0 +1,85 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2017, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __DDRAMC_TIMINGS_H__
+#define __DDRAMC_TIMINGS_H__
+
+struct ddramc_register;
+
+#define DDRAM_TYPE_DDR2		0
+#define DDRAM_TYPE_DDR3		1
+#define DDRAM_TYPE_LPDDR1	2
+#define DDRAM_TYPE_LPDDR2	3
+#define DDRAM_TYPE_LPDDR3	4
+
+/* A minimum delay: the larger of a time and a number of clock cycles */
+struct ddram_timing {
+	unsigned int	ps;
+	unsigned int	nck;
+};
+
+#define DDRAM_T(ps, nck)	{ (ps), (nck) }
+
+/* The datasheet timings of a DDR-SDRAM part */
+struct ddram_part {
+	const char		*name;
+	unsigned int		type;
+	unsigned int		trefi_ns;	/* average refresh interval */
+
+	struct ddram_timing	tras;
+	struct ddram_timing	trcd;
+	struct ddram_timing	twr;
+	struct ddram_timing	trc;
+	struct ddram_timing	trp;
+	struct ddram_timing	trrd;
+	struct ddram_timing	twtr;
+	struct ddram_timing	tmrd;
+
+	struct ddram_timing	trfc;
+	struct ddram_timing	txsnr;
+	struct ddram_timing	txsrd;
+	struct ddram_timing	txp;
+
+	struct ddram_timing	txard;
+	struct ddram_timing	txards;
+	struct ddram_timing	trtp;
+	struct ddram_timing	tfaw;
+
+	struct ddram_timing	zqcs;
+};
+
+extern const struct ddram_part ddram_mt47h64m16_3;
+extern const struct ddram_part ddram_mt47h128m16_3;
+extern const struct ddram_part ddram_mt41k128m16_125;
+extern const struct ddram_part ddram_mt46h128m16lf_5;
+extern const struct ddram_part ddram_mt42l128m32d1_25;
+extern const struct ddram_part ddram_lpddr3_8gb_1600;
+
+extern int ddramc_timings_config(const struct ddram_part *part,
+				 struct ddramc_register *ddramc_config);
+
+#endif /* #ifndef __DDRAMC_TIMINGS_H__ */
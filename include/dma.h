@@ -0,0 +1,152 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2017, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __DMA_H__
+#define __DMA_H__
+
+/*
+ * Polled DMA transfers on the XDMAC (SAMA5D2/D4) or the AHB DMAC
+ * (SAM9G45/SAM9X5/SAM9N12/SAMA5D3), through the first controller.
+ */
+
+#define DMA_CHANNELS		2	/* channels handled by the driver */
+#define DMA_LIST_MAX		16	/* hardware descriptors per channel */
+
+/* No hardware handshake: memory to memory transfer */
+#define DMA_PERID_NONE		0xff
+
+/*
+ * Flags or'ed into the hardware request of a peripheral. With
+ * DMA_PERID_MEM2PER, each element writes @src to the FIFO at @dst.
+ * DMA_PERID_SRC_FIXED also keeps @src, so that the same datum is sent
+ * over and over, like the dummy bytes clocking a SPI read.
+ */
+#define DMA_PERID_MASK		0xff
+#define DMA_PERID_MEM2PER	0x100
+#define DMA_PERID_SRC_FIXED	0x200
+
+/* Data width, as log2 of the size in bytes */
+#define DMA_WIDTH_BYTE		0
+#define DMA_WIDTH_HALFWORD	1
+#define DMA_WIDTH_WORD		2
+
+/* One element of a linked list transfer */
+struct dma_xfer {
+	unsigned int	src;
+	unsigned int	dst;
+	unsigned int	len;	/* in bytes */
+};
+
+void dma_init(void);
+void dma_cleanup(void);
+
+/*
+ * Start a linked list transfer on channel @chan.
+ * With @perid set to DMA_PERID_NONE, each element is a memory copy.
+ * Otherwise each element reads the FIFO at @src (fixed address) of the
+ * peripheral with hardware request @perid, with @width wide accesses,
+ * or writes the FIFO at @dst with the DMA_PERID_MEM2PER flag.
+ * For memory copies @width is the widest access allowed, reduced to the
+ * alignment of the elements.
+ * Elements longer than the controller block size are split; returns -1
+ * when the list does not fit in DMA_LIST_MAX descriptors.
+ */
+int dma_start(unsigned int chan,
+	      unsigned int perid,
+	      unsigned int width,
+	      const struct dma_xfer *list,
+	      unsigned int count);
+
+/* Returns 1 when done, 0 while running, -1 on bus error */
+int dma_poll(unsigned int chan);
+
+/*
+ * Poll until done; the destination is then coherent for the CPU.
+ * Returns -1 on bus error, or when the transfer outlives a deadline
+ * set by dma_start() from its length; the channel is then stopped.
+ */
+int dma_wait(unsigned int chan);
+
+void dma_stop(unsigned int chan);
+
+static inline int dma_memcpy_start(unsigned int chan,
+				   void *dst,
+				   const void *src,
+				   unsigned int len)
+{
+	struct dma_xfer xfer;
+
+	xfer.src = (unsigned int)src;
+	xfer.dst = (unsigned int)dst;
+	xfer.len = len;
+
+	return dma_start(chan, DMA_PERID_NONE, DMA_WIDTH_WORD, &xfer, 1);
+}
+
+static inline int dma_per2mem_start(unsigned int chan,
+				    unsigned int perid,
+				    unsigned int width,
+				    const void *fifo,
+				    void *dst,
+				    unsigned int len)
+{
+	struct dma_xfer xfer;
+
+	xfer.src = (unsigned int)fifo;
+	xfer.dst = (unsigned int)dst;
+	xfer.len = len;
+
+	return dma_start(chan, perid, width, &xfer, 1);
+}
+
+static inline int dma_mem2per_start(unsigned int chan,
+				    unsigned int perid,
+				    unsigned int width,
+				    const void *src,
+				    void *fifo,
+				    unsigned int len)
+{
+	struct dma_xfer xfer;
+
+	xfer.src = (unsigned int)src;
+	xfer.dst = (unsigned int)fifo;
+	xfer.len = len;
+
+	return dma_start(chan, perid | DMA_PERID_MEM2PER, width, &xfer, 1);
+}
+
+/* Blocking copy of any length on channel 0 */
+int dma_memcpy(void *dst, const void *src, unsigned int len);
+
+/* Controller driver: at91_xdmac.c or at91_dmac.c */
+int dma_hw_start(unsigned int chan,
+		 unsigned int perid,
+		 unsigned int width,
+		 const struct dma_xfer *list,
+		 unsigned int count);
+
+#endif /* #ifndef __DMA_H__ */
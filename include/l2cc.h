@@ -30,5 +30,11 @@
 
 void l2cache_prepare(void);
 void l2cache_enable(void);
+void l2cache_disable(void);
+
+void l2cache_clean_range(unsigned int start, unsigned int end);
+void l2cache_invalidate_range(unsigned int start, unsigned int end);
+
+void l2cache_bench(void);
 
 #endif
@@ -0,0 +1,53 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2017, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __LZ4_H__
+#define __LZ4_H__
+
+#define LZ4_STREAM_HEADER	0
+#define LZ4_STREAM_BLOCKS	1
+#define LZ4_STREAM_DONE		2
+#define LZ4_STREAM_ERROR	3
+
+/* Decoder of an LZ4 frame which may be fed a piece at a time */
+struct lz4_stream {
+	unsigned int		state;
+	unsigned int		flags;		/* frame descriptor FLG byte */
+	const unsigned char	*in;		/* next byte of the frame */
+	unsigned char		*out_start;
+	unsigned char		*out;		/* next byte to write */
+	unsigned char		*out_end;
+};
+
+extern void lz4_stream_init(struct lz4_stream *s,
+			    const void *src,
+			    void *dst,
+			    unsigned int dst_size);
+
+extern int lz4_stream_decode(struct lz4_stream *s, const void *src_end);
+
+#endif /* #ifndef __LZ4_H__ */
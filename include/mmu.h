@@ -0,0 +1,54 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2017, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __MMU_H__
+#define __MMU_H__
+
+/* Translation table: 4096 section descriptors of 1 MB each */
+#define MMU_SECTION_SHIFT	20
+#define MMU_SECTION_SIZE	(1 << MMU_SECTION_SHIFT)
+#define MMU_TABLE_ENTRIES	4096
+#define MMU_TABLE_SIZE		(MMU_TABLE_ENTRIES * 4)
+
+/* cp15.S */
+extern void mmu_cache_enable(unsigned int *ttb);
+extern void mmu_cache_disable(void);
+
+#ifdef CONFIG_MMU
+extern void dcache_clean_range(unsigned int start, unsigned int end);
+extern void dcache_invalidate_range(unsigned int start, unsigned int end);
+#else
+static inline void dcache_clean_range(unsigned int start, unsigned int end) {}
+static inline void dcache_invalidate_range(unsigned int start, unsigned int end) {}
+#endif
+
+/* mmu.c */
+extern void mmu_enable(void);
+extern void mmu_disable(void);
+extern unsigned int mmu_table_addr(void);
+
+#endif /* #ifndef __MMU_H__ */
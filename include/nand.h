@@ -49,6 +49,7 @@ struct nand_chip {
 	unsigned char	buswidth;
 	unsigned char	eccbits;
 	unsigned int	eccwordsize;
+	unsigned char	cache_read;	/* supports READ CACHE */
 };
 
 struct nand_info {
@@ -62,6 +63,7 @@ struct nand_info {
 	unsigned int	pages_block;	/* number of pages in block */
 
 	unsigned int	buswidth;	/* data bus width (8/16 bits) */
+	unsigned int	cache_read;	/* sequential cache read supported */
 
 	void (*command)(unsigned char cmd);
 	void (*address)(unsigned char addr);
@@ -82,6 +84,8 @@ struct nand_info {
 /* Nand flash commands */
 #define CMD_READ_1			0x00
 #define CMD_READ_2			0x30
+#define CMD_READ_CACHE_SEQ		0x31
+#define CMD_READ_CACHE_END		0x3F
 
 #define CMD_READID			0x90
 
@@ -31,6 +31,7 @@
 #include "nand.h"
 
 #define TT_MAX			25
+#define PMECC_SECTORS_MAX	8
 
 /* The PMECC descripter structure */
 struct _PMECC_paramDesc_struct {
@@ -66,11 +67,25 @@ struct _PMECC_paramDesc_struct {
 
 };
 
+/* PMECC result of a page, kept for a deferred correction */
+struct pmecc_page_state {
+	unsigned int	erris;
+	short		rem[PMECC_SECTORS_MAX][TT_MAX];
+};
+
 extern int get_pmecc_bytes(unsigned int sector_size, unsigned int ecc_bits);
 extern int choose_pmecc_info(struct nand_info *nand, struct nand_chip *chip);
 extern int init_pmecc(struct nand_info *nand);
 extern void pmecc_enable(void);
 extern void pmecc_start_data_phase(void);
+extern void pmecc_disable(void);
 extern int pmecc_process(struct nand_info *nand, unsigned char *buffer);
+extern void pmecc_save_state(struct nand_info *nand,
+			     unsigned char *oob,
+			     struct pmecc_page_state *state);
+extern int pmecc_correct(struct nand_info *nand,
+			 unsigned char *buffer,
+			 unsigned char *oob,
+			 struct pmecc_page_state *state);
 
 #endif
@@ -31,17 +31,30 @@
 struct image_info;
 
 
+/* file encrypted with AES-CBC, followed by the AES-CMAC of the cipher text */
 #define AT91_SECURE_MAGIC	0x0000aa55
+/* file encrypted with AES-GCM, followed by the tag */
+#define AT91_SECURE_MAGIC_GCM	0x0001aa55
 
 /* the size of this structure MUST be equal to the size of an AES block */
 typedef struct at91_secure_header {
 	unsigned int		magic;
 	unsigned int		file_size;
-	unsigned int		reserved[2];
+	/* GCM: random per image, the IV is nonce || CONFIG_AES_IV_WORD0 */
+	unsigned int		nonce[2];
 } at91_secure_header_t;
 
 
 int secure_decrypt(void *data, unsigned int data_length, int is_signed);
 int secure_check(void *data);
 
+#ifdef CONFIG_SECURE_STREAM
+void secure_stream_start(void *data);
+void secure_stream_update(const void *data, unsigned int length);
+#else
+static inline void secure_stream_start(void *data) {}
+static inline void secure_stream_update(const void *data,
+					unsigned int length) {}
+#endif
+
 #endif /* #ifdef __SECURE_H__ */
@@ -51,6 +51,7 @@ extern int at91_spi_init(unsigned int pcs,
 			unsigned int mode);
 extern void at91_spi_write_data(unsigned short data);
 extern unsigned int at91_spi_read_spi(void);
+extern int at91_spi_read_data(unsigned char *data, unsigned int len);
 extern unsigned int at91_spi_read_sr(void);
 
 #endif	/* #ifndef __SPI_H__ */
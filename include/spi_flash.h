@@ -28,6 +28,10 @@
 #ifndef __SPI_FLASH_H__
 #define __SPI_FLASH_H__
 
+#ifdef CONFIG_SPI_NOR
+int spi_loadimage(struct image_info *image);
+#else
 int spi_flash_loadimage(struct image_info *image);
+#endif
 
 #endif
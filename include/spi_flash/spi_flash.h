@@ -366,6 +366,7 @@ struct spi_ops {
  * @num_wait_states:	The number of wait state clock cycles.
  * @size:		The total SPI flash size (in bytes).
  * @page_size:		The page size (in bytes).
+ * @max_freq:		The maximum (Fast) Read clock frequency, 0 if unknown.
  * @erase_map:		The erase map of the SPI flash.
  * @ops:		[DRIVER-SPECIFIC] The SPI controller interface.
  * @read:		[FLASH-SPECIFIC] Read data from the SPI flash.
@@ -394,6 +395,7 @@ struct spi_flash {
 
 	size_t			size;
 	size_t			page_size;
+	u32			max_freq;
 	struct spi_flash_erase_map	erase_map;
 
 	const struct spi_ops	*ops;
@@ -42,6 +42,7 @@ struct spi_nor_info {
 	u16			n_sectors;
 	u16			page_size;
 	u16			addr_len;
+	u32			max_freq;
 	u16			flags;
 #define SNOR_SECT_4K		(0x1UL << 0)
 #define SNOR_NO_FR		(0x1UL << 1)
@@ -30,10 +30,23 @@
 
 extern int timer_init(void);
 
+extern void ndelay(unsigned int nsec);
 extern void udelay(unsigned int usec);
 extern void mdelay(unsigned int msec);
 
 extern int start_interval_timer(void);
 extern int wait_interval_timer(unsigned int usec);
 
+extern unsigned int timer_get_ticks(void);
+extern unsigned int timer_ticks_to_usec(unsigned int ticks);
+
+/* Monotonic 64-bit ticks, and deadlines for the timeouts of the drivers */
+extern unsigned long long timer_get_ticks64(void);
+extern unsigned long long timer_nsec_to_ticks(unsigned int nsec);
+extern unsigned long long timer_usec_to_ticks(unsigned int usec);
+extern unsigned long long timer_msec_to_ticks(unsigned int msec);
+extern unsigned long long timer_deadline_usec(unsigned int usec);
+extern unsigned long long timer_deadline_msec(unsigned int msec);
+extern int timer_expired(unsigned long long deadline);
+
 #endif /* #ifndef __PIT_TIMER_H__ */
@@ -0,0 +1,105 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2017, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "crc32.h"
+
+#define CRC32_POLY	0xedb88320	/* reflected 0x04c11db7 */
+
+/*
+ * Slice-by-8: table[k][n] is the CRC of byte n followed by k zero bytes,
+ * so that eight bytes are folded in with eight lookups. The tables are
+ * built at the first call rather than stored in the image.
+ */
+#ifdef CONFIG_CRC32_SLICE_BY_8
+#define CRC32_SLICES	8
+#else
+#define CRC32_SLICES	1
+#endif
+
+static unsigned int crc32_table[CRC32_SLICES][256];
+static unsigned int crc32_table_ready;
+
+static void crc32_build_table(void)
+{
+	unsigned int crc;
+	unsigned int i, j;
+
+	for (i = 0; i < 256; i++) {
+		crc = i;
+		for (j = 0; j < 8; j++)
+			crc = (crc >> 1) ^ ((crc & 1) ? CRC32_POLY : 0);
+
+		crc32_table[0][i] = crc;
+	}
+
+	for (j = 1; j < CRC32_SLICES; j++)
+		for (i = 0; i < 256; i++) {
+			crc = crc32_table[j - 1][i];
+			crc32_table[j][i] = (crc >> 8)
+					    ^ crc32_table[0][crc & 0xff];
+		}
+
+	crc32_table_ready = 1;
+}
+
+unsigned int crc32(unsigned int crc, const void *buf, unsigned int len)
+{
+	const unsigned char *p = (const unsigned char *)buf;
+
+	if (!crc32_table_ready)
+		crc32_build_table();
+
+	crc = ~crc;
+
+#ifdef CONFIG_CRC32_SLICE_BY_8
+	while (len && ((unsigned int)p & 3)) {
+		crc = crc32_table[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+		len--;
+	}
+
+	while (len >= 8) {
+		unsigned int one = *(const unsigned int *)p ^ crc;
+		unsigned int two = *(const unsigned int *)(p + 4);
+
+		crc = crc32_table[7][one & 0xff]
+		      ^ crc32_table[6][(one >> 8) & 0xff]
+		      ^ crc32_table[5][(one >> 16) & 0xff]
+		      ^ crc32_table[4][one >> 24]
+		      ^ crc32_table[3][two & 0xff]
+		      ^ crc32_table[2][(two >> 8) & 0xff]
+		      ^ crc32_table[1][(two >> 16) & 0xff]
+		      ^ crc32_table[0][two >> 24];
+		p += 8;
+		len -= 8;
+	}
+#endif
+
+	while (len--)
+		crc = crc32_table[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+
+	return ~crc;
+}
@@ -8,4 +8,5 @@ COBJS-y		+= $(LIB)/eabi_utils.o
 COBJS-y		+= $(LIB)/div.o
 
 COBJS-$(CONFIG_CRC32)	+= $(LIB)/crc32.o
+COBJS-$(CONFIG_KERNEL_LZ4) += $(LIB)/lz4.o
 COBJS-$(CONFIG_OF_LIBFDT) += $(LIB)/fdt.o
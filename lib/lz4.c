@@ -0,0 +1,227 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2017, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "common.h"
+#include "string.h"
+#include "lz4.h"
+
+/*
+ * LZ4 frame decoder, as written by the lz4 tool: the frame header, then
+ * blocks up to the end mark. Blocks are decoded as soon as they are
+ * complete in the input, so that the frame can be decompressed while it
+ * is being read. The output is contiguous, which also serves the frames
+ * of linked blocks. Checksums are skipped.
+ */
+#define LZ4_FRAME_MAGIC		0x184d2204
+
+#define LZ4_FLG_VERSION_MASK	(0x3 << 6)
+#define LZ4_FLG_VERSION		(0x1 << 6)
+#define LZ4_FLG_BLOCK_CHECKSUM	(0x1 << 4)
+#define LZ4_FLG_CONTENT_SIZE	(0x1 << 3)
+#define LZ4_FLG_CONTENT_CHECKSUM (0x1 << 2)
+#define LZ4_FLG_DICT_ID		(0x1 << 0)
+
+#define LZ4_BLOCK_UNCOMPRESSED	(0x1UL << 31)
+
+#define LZ4_MIN_MATCH		4
+
+static unsigned int get_le32(const unsigned char *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24);
+}
+
+/* Extended length of a literal run or of a match */
+static int lz4_length(const unsigned char **in,
+		      const unsigned char *in_end,
+		      unsigned int *length)
+{
+	unsigned char byte;
+
+	do {
+		if (*in >= in_end)
+			return -1;
+		byte = *(*in)++;
+		*length += byte;
+	} while (byte == 255);
+
+	return 0;
+}
+
+static int lz4_decode_block(struct lz4_stream *s,
+			    const unsigned char *in,
+			    unsigned int size)
+{
+	const unsigned char *in_end = in + size;
+	unsigned char *out = s->out;
+	unsigned char *match;
+	unsigned int token, length, offset;
+
+	while (in < in_end) {
+		token = *in++;
+
+		/* literals */
+		length = token >> 4;
+		if ((length == 15) && lz4_length(&in, in_end, &length))
+			return -1;
+
+		if ((length > (unsigned int)(in_end - in))
+		    || (length > (unsigned int)(s->out_end - out)))
+			return -1;
+
+		memcpy(out, in, length);
+		in += length;
+		out += length;
+
+		/* the last sequence has no match */
+		if (in == in_end)
+			break;
+
+		/* match */
+		if (in_end - in < 2)
+			return -1;
+
+		offset = in[0] | (in[1] << 8);
+		in += 2;
+		if (!offset || (offset > (unsigned int)(out - s->out_start)))
+			return -1;
+
+		length = token & 0xf;
+		if ((length == 15) && lz4_length(&in, in_end, &length))
+			return -1;
+		length += LZ4_MIN_MATCH;
+
+		if (length > (unsigned int)(s->out_end - out))
+			return -1;
+
+		match = out - offset;
+		if (offset >= length) {
+			memcpy(out, match, length);
+			out += length;
+		} else {
+			/* overlapping: the pattern repeats itself */
+			while (length--)
+				*out++ = *match++;
+		}
+	}
+
+	s->out = out;
+
+	return 0;
+}
+
+void lz4_stream_init(struct lz4_stream *s,
+		     const void *src,
+		     void *dst,
+		     unsigned int dst_size)
+{
+	s->state = LZ4_STREAM_HEADER;
+	s->flags = 0;
+	s->in = (const unsigned char *)src;
+	s->out_start = (unsigned char *)dst;
+	s->out = s->out_start;
+	s->out_end = s->out_start + dst_size;
+}
+
+/*
+ * Decode what the input holds up to @src_end.
+ * Returns 1 at the end of the frame, 0 if more input is needed, -1 on
+ * a corrupted frame or an output overflow.
+ */
+int lz4_stream_decode(struct lz4_stream *s, const void *src_end)
+{
+	const unsigned char *in_end = (const unsigned char *)src_end;
+	unsigned int avail, length, size;
+
+	while (1) {
+		if (s->state == LZ4_STREAM_DONE)
+			return 1;
+
+		if (s->state == LZ4_STREAM_ERROR)
+			return -1;
+
+		avail = (in_end > s->in) ? in_end - s->in : 0;
+
+		if (s->state == LZ4_STREAM_HEADER) {
+			/* magic, FLG, BD, ..., HC */
+			if (avail < 7)
+				return 0;
+
+			s->flags = s->in[4];
+			if ((get_le32(s->in) != LZ4_FRAME_MAGIC)
+			    || ((s->flags & LZ4_FLG_VERSION_MASK)
+				!= LZ4_FLG_VERSION)) {
+				s->state = LZ4_STREAM_ERROR;
+				continue;
+			}
+
+			length = 7;
+			if (s->flags & LZ4_FLG_CONTENT_SIZE)
+				length += 8;
+			if (s->flags & LZ4_FLG_DICT_ID)
+				length += 4;
+			if (avail < length)
+				return 0;
+
+			s->in += length;
+			s->state = LZ4_STREAM_BLOCKS;
+			continue;
+		}
+
+		/* block size, data, checksum */
+		if (avail < 4)
+			return 0;
+
+		size = get_le32(s->in);
+		if (!size) {
+			/* end mark, the content checksum is not checked */
+			s->in += 4;
+			s->state = LZ4_STREAM_DONE;
+			continue;
+		}
+
+		length = 4 + (size & ~LZ4_BLOCK_UNCOMPRESSED);
+		if (s->flags & LZ4_FLG_BLOCK_CHECKSUM)
+			length += 4;
+		if (avail < length)
+			return 0;
+
+		if (size & LZ4_BLOCK_UNCOMPRESSED) {
+			size &= ~LZ4_BLOCK_UNCOMPRESSED;
+			if (size > (unsigned int)(s->out_end - s->out)) {
+				s->state = LZ4_STREAM_ERROR;
+				continue;
+			}
+			memcpy(s->out, s->in + 4, size);
+			s->out += size;
+		} else if (lz4_decode_block(s, s->in + 4, size)) {
+			s->state = LZ4_STREAM_ERROR;
+			continue;
+		}
+
+		s->in += length;
+	}
+}
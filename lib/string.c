@@ -28,25 +28,194 @@
 #include "string.h"
 #include "common.h"
 
+/*
+ * The image loaders move several megabytes through memcpy(), so the copy
+ * and fill helpers work on words whenever the alignment allows it, and
+ * on bursts of eight words (one LDM/STM pair, one cache line) in the
+ * middle of large buffers.
+ */
+#define WORD_SIZE	4
+#define WORD_MASK	(WORD_SIZE - 1)
+#define BURST_SIZE	(8 * WORD_SIZE)
+
+#if !defined(__arm__) || (defined(__thumb__) && !defined(__thumb2__))
+/*
+ * Thumb-1 only reaches the eight low registers, leave the scheduling of
+ * the burst to the compiler. So do the host builds of host-utilities/test.
+ */
+static inline void copy_burst(unsigned int **dst, const unsigned int **src)
+{
+	unsigned int *d = *dst;
+	const unsigned int *s = *src;
+
+	d[0] = s[0]; d[1] = s[1]; d[2] = s[2]; d[3] = s[3];
+	d[4] = s[4]; d[5] = s[5]; d[6] = s[6]; d[7] = s[7];
+
+	*dst = d + 8;
+	*src = s + 8;
+}
+
+static inline void fill_burst(unsigned int **dst, unsigned int val)
+{
+	unsigned int *d = *dst;
+
+	d[0] = val; d[1] = val; d[2] = val; d[3] = val;
+	d[4] = val; d[5] = val; d[6] = val; d[7] = val;
+
+	*dst = d + 8;
+}
+#else
+static inline void copy_burst(unsigned int **dst, const unsigned int **src)
+{
+	unsigned int *d = *dst;
+	const unsigned int *s = *src;
+
+	asm volatile (
+#ifdef CONFIG_CPU_V7
+		"pld	[%1, #64]\n\t"
+#endif
+		"ldmia	%1!, {r3, r4, r5, r6, r8, r9, r10, r12}\n\t"
+		"stmia	%0!, {r3, r4, r5, r6, r8, r9, r10, r12}\n\t"
+		: "+r" (d), "+r" (s)
+		:
+		: "r3", "r4", "r5", "r6", "r8", "r9", "r10", "r12", "memory");
+
+	*dst = d;
+	*src = s;
+}
+
+static inline void fill_burst(unsigned int **dst, unsigned int val)
+{
+	unsigned int *d = *dst;
+
+	asm volatile (
+		"mov	r3, %1\n\t"
+		"mov	r4, %1\n\t"
+		"mov	r5, %1\n\t"
+		"mov	r6, %1\n\t"
+		"stmia	%0!, {r3, r4, r5, r6}\n\t"
+		"stmia	%0!, {r3, r4, r5, r6}\n\t"
+		: "+r" (d)
+		: "r" (val)
+		: "r3", "r4", "r5", "r6", "memory");
+
+	*dst = d;
+}
+#endif
+
+/*
+ * Copy words to an aligned destination from a source that is not word
+ * aligned, by merging two aligned source words per destination word.
+ * @off is the misalignment of the source (1, 2 or 3).
+ */
+static void copy_words_shifted(unsigned int *d,
+			       const unsigned char *src,
+			       unsigned int words,
+			       unsigned int off)
+{
+	const unsigned int *s = (const unsigned int *)(src - off);
+	unsigned int lshift = off * 8;
+	unsigned int rshift = 32 - lshift;
+	unsigned int cur, next;
+
+	cur = *s++;
+	while (words--) {
+		next = *s++;
+		*d++ = (cur >> lshift) | (next << rshift);
+		cur = next;
+	}
+}
+
 void *memcpy(void *dst, const void *src, int cnt)
 {
-	char *d = (char *)dst;
-	const char *s = (const char *)src;
+	unsigned char *d = (unsigned char *)dst;
+	const unsigned char *s = (const unsigned char *)src;
+	unsigned int *wd;
+	const unsigned int *ws;
+	unsigned int n = cnt;
+	unsigned int words;
+
+	if (n < 2 * WORD_SIZE)
+		goto tail;
+
+	/* Align the destination first, stores are the expensive side */
+	while ((unsigned int)d & WORD_MASK) {
+		*d++ = *s++;
+		n--;
+	}
 
-	while (cnt--)
+	wd = (unsigned int *)d;
+	if ((unsigned int)s & WORD_MASK) {
+		/*
+		 * The merge loop reads one word ahead, keep the last
+		 * source word out of it to stay inside the buffer.
+		 */
+		words = (n >> 2) - 1;
+		copy_words_shifted(wd, s, words, (unsigned int)s & WORD_MASK);
+		d += words * WORD_SIZE;
+		s += words * WORD_SIZE;
+		n -= words * WORD_SIZE;
+		goto tail;
+	}
+
+	ws = (const unsigned int *)s;
+	while (n >= BURST_SIZE) {
+		copy_burst(&wd, &ws);
+		n -= BURST_SIZE;
+	}
+
+	while (n >= WORD_SIZE) {
+		*wd++ = *ws++;
+		n -= WORD_SIZE;
+	}
+
+	d = (unsigned char *)wd;
+	s = (const unsigned char *)ws;
+
+tail:
+	while (n--)
 		*d++ = *s++;
 
-	return d;
+	return dst;
 }
 
 void *memset(void *dst, int val, int cnt)
 {
-	char *d = (char *)dst;
+	unsigned char *d = (unsigned char *)dst;
+	unsigned int *wd;
+	unsigned int n = cnt;
+	unsigned int pattern;
 
-	while (cnt--)
-		*d++ = (char)val;
+	if (n < 2 * WORD_SIZE)
+		goto tail;
+
+	while ((unsigned int)d & WORD_MASK) {
+		*d++ = (unsigned char)val;
+		n--;
+	}
+
+	pattern = val & 0xff;
+	pattern |= pattern << 8;
+	pattern |= pattern << 16;
 
-	return d;
+	wd = (unsigned int *)d;
+	while (n >= BURST_SIZE) {
+		fill_burst(&wd, pattern);
+		n -= BURST_SIZE;
+	}
+
+	while (n >= WORD_SIZE) {
+		*wd++ = pattern;
+		n -= WORD_SIZE;
+	}
+
+	d = (unsigned char *)wd;
+
+tail:
+	while (n--)
+		*d++ = (unsigned char)val;
+
+	return dst;
 }
 
 int memcmp(const void *dst, const void *src, unsigned int cnt)
@@ -176,20 +345,38 @@ void *memchr(void *src, int val, unsigned int cnt)
 
 void *memmove(void *dst, const void *src, unsigned int cnt)
 {
-	char *p, *s;
+	unsigned char *p;
+	const unsigned char *s;
+	unsigned int *wp;
+	const unsigned int *ws;
 
-	if (dst <= src) {
-		p = (char *)dst;
-		s = (char *)src;
-		while (cnt--)
-			*p++ = *s++;
-		}
-	else {
-		p = (char *)dst + cnt;
-		s = (char *)src + cnt;
-		while (cnt--)
+	/* A forward copy never overwrites source bytes it still has to read */
+	if ((dst <= src)
+	    || ((const unsigned char *)src + cnt <= (unsigned char *)dst))
+		return memcpy(dst, src, cnt);
+
+	p = (unsigned char *)dst + cnt;
+	s = (const unsigned char *)src + cnt;
+
+	if ((((unsigned int)p ^ (unsigned int)s) & WORD_MASK) == 0) {
+		while (cnt && ((unsigned int)p & WORD_MASK)) {
 			*--p = *--s;
+			cnt--;
 		}
 
+		wp = (unsigned int *)p;
+		ws = (const unsigned int *)s;
+		while (cnt >= WORD_SIZE) {
+			*--wp = *--ws;
+			cnt -= WORD_SIZE;
+		}
+
+		p = (unsigned char *)wp;
+		s = (const unsigned char *)ws;
+	}
+
+	while (cnt--)
+		*--p = *--s;
+
 	return dst;
 }
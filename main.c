@@ -36,6 +36,9 @@
 #include "backup.h"
 #include "secure.h"
 #include "sfr_aicredir.h"
+#include "mmu.h"
+#include "l2cc.h"
+#include "bootstage.h"
 
 #ifdef CONFIG_HW_DISPLAY_BANNER
 static void display_banner (void)
@@ -52,6 +55,7 @@ int main(void)
 #ifdef CONFIG_HW_INIT
 	hw_init();
 #endif
+	bootstage_mark("hw_init");
 
 #if defined(CONFIG_SCLK)
 #if !defined(CONFIG_SCLK_BYPASS)
@@ -66,21 +70,31 @@ int main(void)
 		redirect_interrupts_to_nsaic();
 #endif
 		slowclk_switch_osc32();
+		usart_flush();
 
 		return ret;
 	}
 #endif
 
+#ifdef CONFIG_MMU
+	mmu_enable();
+#endif
+
 #ifdef CONFIG_HW_DISPLAY_BANNER
 	display_banner();
 #endif
 
+#ifdef CONFIG_L2CACHE_BENCH
+	l2cache_bench();
+#endif
+
 #ifdef CONFIG_REDIRECT_ALL_INTS_AIC
 	redirect_interrupts_to_nsaic();
 #endif
 
 #ifdef CONFIG_LOAD_HW_INFO
 	load_board_hw_info();
+	bootstage_mark("board_hw_info");
 #endif
 
 #ifdef CONFIG_PM
@@ -97,14 +111,17 @@ int main(void)
 
 #if defined(CONFIG_SECURE)
 	image.dest -= sizeof(at91_secure_header_t);
+	secure_stream_start(image.dest);
 #endif
 
 	ret = (*load_image)(&image);
+	bootstage_mark("load");
 
 #if defined(CONFIG_SECURE)
 	if (!ret)
 		ret = secure_check(image.dest);
 	image.dest += sizeof(at91_secure_header_t);
+	bootstage_mark("secure");
 #endif
 
 	load_image_done(ret);
@@ -117,6 +134,14 @@ int main(void)
 #endif
 #endif
 
+	bootstage_mark("jump");
+	bootstage_report();
+	usart_flush();
+
+#ifdef CONFIG_MMU
+	mmu_disable();
+#endif
+
 #if defined(CONFIG_ENTER_NWD)
 	switch_normal_world();
 
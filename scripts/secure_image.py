@@ -0,0 +1,115 @@
+#!/usr/bin/env python
+#
+# Pack an application image for the CONFIG_SECURE mode, with the keys
+# and the IV of the at91bootstrap .config:
+#
+#	secure_image.py [--cmac] .config <image.bin> <image.bin.secure>
+#
+# The secure header (magic, file size, nonce) is encrypted with AES-CBC.
+# By default the file is then encrypted with AES-GCM, the plain header
+# being the additional authenticated data, and followed by the tag. With
+# --cmac, it is encrypted with AES-CBC and followed by the AES-CMAC of
+# the cipher text, for the bootstraps older than the GCM support.
+#
+# Requires the python "cryptography" package.
+
+import os, re, struct, sys
+
+from cryptography.hazmat.backends import default_backend
+from cryptography.hazmat.primitives.ciphers import Cipher, algorithms, modes
+from cryptography.hazmat.primitives.ciphers.aead import AESGCM
+from cryptography.hazmat.primitives.cmac import CMAC
+
+AT91_SECURE_MAGIC = 0x0000aa55
+AT91_SECURE_MAGIC_GCM = 0x0001aa55
+
+def read_config(fname):
+	config = {}
+	for line in open(fname):
+		m = re.match(r'^(CONFIG_\w+)=(.*)$', line.strip())
+		if m:
+			config[m.group(1)] = m.group(2).strip('"')
+	return config
+
+def config_words(config, name, count):
+	'''
+	the words of a key or of the IV, as the bootstrap writes them to
+	the AES: most significant byte first
+	'''
+	words = [int(config[name % i], 16) for i in range(count)]
+	return struct.pack('>%dI' % count, *words)
+
+def get_keys(config):
+	if config.get('CONFIG_AES_KEY_SIZE_128') == 'y':
+		count = 4
+	elif config.get('CONFIG_AES_KEY_SIZE_192') == 'y':
+		count = 6
+	else:
+		count = 8
+
+	cipher_key = config_words(config, 'CONFIG_AES_CIPHER_KEY_WORD%d', count)
+	cmac_key = config_words(config, 'CONFIG_AES_CMAC_KEY_WORD%d', count)
+	iv = config_words(config, 'CONFIG_AES_IV_WORD%d', 4)
+
+	return cipher_key, cmac_key, iv
+
+def cbc_encrypt(key, iv, data):
+	encryptor = Cipher(algorithms.AES(key), modes.CBC(iv),
+			   backend=default_backend()).encryptor()
+	return encryptor.update(data) + encryptor.finalize()
+
+def pack(config, data, use_cmac):
+	cipher_key, cmac_key, iv = get_keys(config)
+
+	file_size = len(data)
+	if not file_size:
+		sys.exit('Empty image!')
+
+	# the file is processed by whole AES blocks
+	data += b'\0' * (-file_size % 16)
+
+	if use_cmac:
+		header = struct.pack('<IIII', AT91_SECURE_MAGIC, file_size, 0, 0)
+
+		cipher_text = cbc_encrypt(cipher_key, iv, data)
+
+		cmac = CMAC(algorithms.AES(cmac_key), backend=default_backend())
+		cmac.update(cipher_text)
+		trailer = cmac.finalize()
+	else:
+		nonce = struct.unpack('<II', os.urandom(8))
+		header = struct.pack('<IIII', AT91_SECURE_MAGIC_GCM, file_size,
+				     nonce[0], nonce[1])
+
+		# nonce || CONFIG_AES_IV_WORD0, as the bootstrap builds it
+		gcm_iv = struct.pack('>II', nonce[0], nonce[1]) + iv[:4]
+		sealed = AESGCM(cipher_key).encrypt(gcm_iv, data, header)
+		cipher_text = sealed[:-16]
+		trailer = sealed[-16:]
+
+	return cbc_encrypt(cipher_key, iv, header) + cipher_text + trailer
+
+def main(argv):
+	use_cmac = False
+	if argv and argv[0] == '--cmac':
+		use_cmac = True
+		argv = argv[1:]
+
+	if len(argv) != 3:
+		sys.exit('Usage: %s [--cmac] .config <image> <secure image>'
+			 % os.path.basename(sys.argv[0]))
+
+	config = read_config(argv[0])
+	if config.get('CONFIG_SECURE') != 'y':
+		sys.exit('CONFIG_SECURE is not set in %s!' % argv[0])
+
+	fd = open(argv[1], 'rb')
+	data = fd.read()
+	fd.close()
+
+	fd = open(argv[2], 'wb')
+	fd.write(pack(config, data, use_cmac))
+	fd.close()
+
+if __name__ == '__main__':
+	main(sys.argv[1:])
@@ -19,6 +19,14 @@ ifeq ($(CONFIG_DEBUG),y)
 CPPFLAGS += -DCONFIG_DEBUG
 endif
 
+ifeq ($(CONFIG_BOOTSTAGE),y)
+CPPFLAGS += -DCONFIG_BOOTSTAGE
+endif
+
+ifeq ($(CONFIG_USART_TX_BUFFER),y)
+CPPFLAGS += -DCONFIG_USART_TX_BUFFER
+endif
+
 ifeq ($(CONFIG_HW_DISPLAY_BANNER),y)
 BANNER:="$(CONFIG_HW_BANNER)"
 CPPFLAGS += -DBANNER="$(BANNER)"
@@ -33,6 +41,23 @@ ifeq ($(CONFIG_USER_HW_INIT),y)
 CPPFLAGS += -DCONFIG_USER_HW_INIT
 endif
 
+ifeq ($(CONFIG_MMU),y)
+CPPFLAGS += -DCONFIG_MMU
+endif
+
+ifeq ($(CONFIG_L2CACHE),y)
+CPPFLAGS += -DCONFIG_L2CACHE
+ASFLAGS += -DCONFIG_L2CACHE
+endif
+
+ifeq ($(CONFIG_L2CACHE_BENCH),y)
+CPPFLAGS += -DCONFIG_L2CACHE_BENCH
+endif
+
+ifeq ($(CONFIG_DMA),y)
+CPPFLAGS += -DCONFIG_DMA
+endif
+
 ifeq ($(CONFIG_OVERRIDE_CMDLINE),y)
 CPPFLAGS += -DCONFIG_OVERRIDE_CMDLINE
 endif